@@ -1,4 +1,63 @@
-import { words, allowed } from './words.server';
+interface Sverdle {
+	count: number;
+	answer(index: number): string;
+	enter(word: string, index: number): string | null;
+}
+
+/**
+ * The word list, dictionary and scorer, compiled into the hello module from
+ * words.server.ts (see wasm/sverdle.cpp). The module only exists once
+ * wasm/build.sh has been run, so a checkout without emsdk plays with the
+ * word lists directly; they are only imported then, so a server with the
+ * module never parses them.
+ */
+const modules = import.meta.glob('/src/lib/wasm/hello.loader.js');
+const sverdle: Sverdle = await load();
+
+async function load(): Promise<Sverdle> {
+	const loader = modules['/src/lib/wasm/hello.loader.js'];
+	if (loader) {
+		const { default: instantiate_hello } = (await loader()) as {
+			default: () => Promise<{ sverdle: Sverdle }>;
+		};
+		return (await instantiate_hello()).sverdle;
+	}
+
+	const { words, allowed } = await import('./words.server');
+	return {
+		count: words.length,
+		answer: (index) => words[index],
+		enter(word, answerIndex) {
+			if (!allowed.has(word)) return null;
+
+			const available = Array.from(words[answerIndex]);
+			const answer = Array(5).fill('_');
+
+			// first, find exact matches
+			for (let i = 0; i < 5; i += 1) {
+				if (word[i] === available[i]) {
+					answer[i] = 'x';
+					available[i] = ' ';
+				}
+			}
+
+			// then find close matches (this has to happen
+			// in a second step, otherwise an early close
+			// match can prevent a later exact match)
+			for (let i = 0; i < 5; i += 1) {
+				if (answer[i] === '_') {
+					const index = available.indexOf(word[i]);
+					if (index !== -1) {
+						answer[i] = 'c';
+						available[index] = ' ';
+					}
+				}
+			}
+
+			return answer.join('');
+		}
+	};
+}
 
 export class Game {
 	index: number;
@@ -17,12 +76,12 @@ export class Game {
 			this.guesses = guesses ? guesses.split(' ') : [];
 			this.answers = answers ? answers.split(' ') : [];
 		} else {
-			this.index = Math.floor(Math.random() * words.length);
+			this.index = Math.floor(Math.random() * sverdle.count);
 			this.guesses = ['', '', '', '', '', ''];
 			this.answers = [];
 		}
 
-		this.answer = words[this.index];
+		this.answer = sverdle.answer(this.index);
 	}
 
 	/**
@@ -31,37 +90,12 @@ export class Game {
 	 */
 	enter(letters: string[]) {
 		const word = letters.join('');
-		const valid = allowed.has(word);
+		const feedback: string | null = sverdle.enter(word, this.index);
 
-		if (!valid) return false;
+		if (feedback === null) return false;
 
 		this.guesses[this.answers.length] = word;
-
-		const available = Array.from(this.answer);
-		const answer = Array(5).fill('_');
-
-		// first, find exact matches
-		for (let i = 0; i < 5; i += 1) {
-			if (letters[i] === available[i]) {
-				answer[i] = 'x';
-				available[i] = ' ';
-			}
-		}
-
-		// then find close matches (this has to happen
-		// in a second step, otherwise an early close
-		// match can prevent a later exact match)
-		for (let i = 0; i < 5; i += 1) {
-			if (answer[i] === '_') {
-				const index = available.indexOf(letters[i]);
-				if (index !== -1) {
-					answer[i] = 'c';
-					available[index] = ' ';
-				}
-			}
-		}
-
-		this.answers.push(answer.join(''));
+		this.answers.push(feedback);
 
 		return true;
 	}
@@ -1,5 +1,6 @@
 Module['onRuntimeInitialized'] = function ()
 {
-  Module['add'] = cwrap( 'add', 'number', ['number','number'] );
-  Module['hello'] = cwrap( 'hello', 'string', null );
+  // Direct exports instead of cwrap closures
+  Module['add'] = _add;
+  Module['hello'] = function() { return UTF8ToString( _hello() ); };
 }
@@ -0,0 +1,84 @@
+#include "arena.hpp"
+
+#include "memzero.hpp"
+#include "stats.hpp"
+
+namespace Hello
+{
+
+Arena::Arena(size_t block_size, bool wipe, size_t max_kept)
+    : head_(nullptr), block_size_(block_size), max_kept_(max_kept > block_size ? max_kept : block_size), used_(0), wipe_(wipe) {
+}
+
+Arena::~Arena() {
+    while(head_) {
+        Block* next = head_->next;
+        wipe(head_);
+        stats_free(head_);
+        head_ = next;
+    }
+}
+
+Arena::Block* Arena::new_block(size_t size) {
+    auto block = (Block*)stats_malloc(sizeof(Block) + size);
+    if(block) {
+        block->next = head_;
+        block->size = size;
+        block->top = 0;
+        head_ = block;
+    }
+    return block;
+}
+
+void Arena::wipe(Block* block) {
+    if(wipe_ && block->top) {
+        memzero(block + 1, block->top);
+    }
+}
+
+void* Arena::alloc(size_t size, size_t align) {
+    if(size > SIZE_MAX - align) {
+        return nullptr;
+    }
+    if(head_) {
+        uintptr_t base = (uintptr_t)(head_ + 1);
+        uintptr_t start = (base + head_->top + align - 1) & ~(uintptr_t)(align - 1);
+        if(start <= base + head_->size && size <= base + head_->size - start) {
+            used_ += start + size - (base + head_->top);
+            head_->top = start + size - base;
+            return (void*)start;
+        }
+    }
+
+    size_t wanted = size + align;
+    if(!new_block(wanted > block_size_ ? wanted : block_size_)) {
+        return nullptr;
+    }
+    return alloc(size, align);
+}
+
+void Arena::reset() {
+    if(head_ && (head_->next || head_->size > max_kept_)) {
+        // The last round needed more than one block (or one oversized block):
+        // replace them with a single block large enough for all of it, up to
+        // max_kept_.
+        size_t total = 0;
+        while(head_) {
+            Block* next = head_->next;
+            total += head_->size;
+            wipe(head_);
+            stats_free(head_);
+            head_ = next;
+        }
+        if(total > block_size_) {
+            block_size_ = total < max_kept_ ? total : max_kept_;
+        }
+        new_block(block_size_);
+    } else if(head_) {
+        wipe(head_);
+        head_->top = 0;
+    }
+    used_ = 0;
+}
+
+} // namespace Hello
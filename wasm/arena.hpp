@@ -0,0 +1,58 @@
+#ifndef HELLO_ARENA_HPP
+#define HELLO_ARENA_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Hello
+{
+
+// Bump allocator for short-lived buffers. Allocation is a pointer increment;
+// everything is released at once by reset(), which keeps the memory for the
+// next round. If a round outgrows the current block, further blocks are
+// chained and merged into one block of the combined size on reset, so a
+// steady workload settles on a single allocation. The merged block is capped
+// at max_kept bytes: a round that needed more (one huge input) frees the
+// excess on reset instead of keeping it for the life of the arena.
+//
+// With wipe set, reset() and the destructor first zero the bytes each block
+// handed out, with one memzero call per block, so inputs marshalled through
+// the arena do not linger in the heap.
+class Arena {
+public:
+    explicit Arena(size_t block_size = 64 * 1024, bool wipe = false, size_t max_kept = 4 * 1024 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Returns size bytes aligned to align (a power of two), or nullptr if the
+    // system allocator is out of memory.
+    void* alloc(size_t size, size_t align = 16);
+
+    // Releases every allocation made since the previous reset.
+    void reset();
+
+    // Bytes handed out since the previous reset.
+    size_t used() const { return used_; }
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+        size_t top;
+    };
+
+    Block* new_block(size_t size);
+    void wipe(Block* block);
+
+    Block* head_;
+    size_t block_size_;
+    size_t max_kept_;
+    size_t used_;
+    bool wipe_;
+};
+
+} // namespace Hello
+
+#endif
@@ -0,0 +1,59 @@
+// Cold-start latency of the hello module: each sample is a fresh Node
+// process (no warm isolate, no compiled-code cache) that instantiates the
+// module and makes its first call.
+//
+//   import    loading hello.loader.js and the emcc glue
+//   ready     instantiate_hello() until the module promise resolves
+//   first     the first Module.sha256 call, bindings and all
+//
+// Pass one directory per build to compare, e.g. a build of the previous
+// commit against the current one:
+//
+//   node bench/coldstart.bench.mjs [--runs=N] [--flavor=baseline|simd] before/ ../src/lib/wasm
+
+import { execFileSync } from 'node:child_process';
+import path from 'node:path';
+import { pathToFileURL } from 'node:url';
+
+let runs = 15;
+let flavor = 'baseline';
+const dirs = [];
+for(const arg of process.argv.slice(2)) {
+    if(arg.startsWith('--runs=')) {
+        runs = Number(arg.slice(7));
+    } else if(arg.startsWith('--flavor=')) {
+        flavor = arg.slice(9);
+    } else {
+        dirs.push(path.resolve(arg));
+    }
+}
+if(!dirs.length) {
+    dirs.push(path.resolve('../src/lib/wasm'));
+}
+
+// Runs in the child; prints the three phases in milliseconds.
+const probe = (loader) => `
+const t0 = performance.now();
+const { default: instantiate_hello } = await import(${JSON.stringify(loader)});
+const t1 = performance.now();
+const mod = await instantiate_hello({}, ${JSON.stringify(flavor)});
+const t2 = performance.now();
+mod.sha256('');
+const t3 = performance.now();
+console.log(JSON.stringify([t1 - t0, t2 - t1, t3 - t2]));
+`;
+
+const median = (values) => values.slice().sort((a, b) => a - b)[values.length >> 1];
+
+console.log('build'.padEnd(40) + 'import'.padStart(10) + 'ready'.padStart(10) + 'first'.padStart(10) + 'total'.padStart(10));
+for(const dir of dirs) {
+    const loader = pathToFileURL(path.join(dir, 'hello.loader.js')).href;
+    const samples = [];
+    for(let i = 0; i < runs; i++) {
+        const out = execFileSync(process.execPath, ['--input-type=module', '-e', probe(loader)], { encoding: 'utf8' });
+        samples.push(JSON.parse(out.trim().split('\n').pop()));
+    }
+    const phases = [0, 1, 2].map((k) => median(samples.map((s) => s[k])));
+    const total = median(samples.map((s) => s[0] + s[1] + s[2]));
+    console.log(path.relative(process.cwd(), dir).padEnd(40) + [...phases, total].map((ms) => ms.toFixed(2).padStart(10)).join(''));
+}
@@ -0,0 +1,53 @@
+// Lines up kernels.bench results by (kernel, size, threads) and prints GB/s
+// for every file and layer, with each column's ratio to the first one.
+// Columns are named after the files.
+//
+//   node bench/compare.mjs native.json wasm.json
+//
+// With a native and a wasm file the columns are native raw, wasm raw and
+// wasm wrapped: the first ratio is the wasm-vs-native gap, the difference
+// between the two wasm columns is marshalling. Two runs of the same suite
+// (before/after a change) compare the same way.
+
+import fs from 'node:fs';
+import path from 'node:path';
+
+const files = process.argv.slice(2);
+if(files.length < 2) {
+    console.error('usage: compare.mjs baseline.json other.json [more.json ...]');
+    process.exit(2);
+}
+
+const columns = [];
+const rows = new Map();
+for(const file of files) {
+    const suite = JSON.parse(fs.readFileSync(file, 'utf8'));
+    const label = path.basename(file, '.json');
+    for(const r of suite.results) {
+        const column = `${label} ${r.layer}`;
+        if(!columns.includes(column)) {
+            columns.push(column);
+        }
+        const key = `${r.kernel}\t${r.size}\t${r.threads}`;
+        if(!rows.has(key)) {
+            rows.set(key, new Map());
+        }
+        rows.get(key).set(column, r.gb_per_s);
+    }
+}
+
+const width = Math.max(...columns.map((c) => c.length), 8) + 10;
+console.log('kernel'.padEnd(14) + 'size'.padStart(10) + 'thr'.padStart(5) + columns.map((c) => c.padStart(width)).join(''));
+for(const [key, values] of rows) {
+    const [kernel, size, threads] = key.split('\t');
+    const base = values.get(columns[0]);
+    const cells = columns.map((column) => {
+        const value = values.get(column);
+        if(value === undefined) {
+            return '-'.padStart(width);
+        }
+        const ratio = base && column !== columns[0] ? ` (${(value / base).toFixed(2)}x)` : '';
+        return `${value.toFixed(3)}${ratio}`.padStart(width);
+    });
+    console.log(kernel.padEnd(14) + size.padStart(10) + threads.padStart(5) + cells.join(''));
+}
@@ -0,0 +1,113 @@
+// Marshalling microbenchmark for the hello.post.js wrappers.
+//
+// "before" re-creates the original per-call marshalling (malloc/free for
+// every buffer, a fresh TextEncoder, element-by-element HEAP32 copies) on top
+// of the current exports; "after" is the scratch-arena wrapper the module
+// ships. Both call the same wasm code, so the difference is marshalling cost.
+//
+//   node bench/hello.post.bench.mjs [dir with hello.loader.js] [baseline|simd]
+
+import path from 'node:path';
+import { pathToFileURL } from 'node:url';
+
+const dir = path.resolve(process.argv[2] ?? '../src/lib/wasm');
+const { default: instantiate_hello } = await import(pathToFileURL(path.join(dir, 'hello.loader.js')));
+const mod = await instantiate_hello({}, process.argv[3]);
+
+const before = {
+    sha256(s) {
+        const utf8 = new TextEncoder().encode(s);
+        const inputPtr = mod._malloc(utf8.length);
+        new Uint8Array(mod.HEAPU8.buffer, inputPtr, utf8.length).set(utf8);
+        const outputPtr = mod._malloc(32);
+        mod.ccall('sha256', null, ['number', 'number', 'number'], [inputPtr, utf8.length, outputPtr]);
+        const o = new Uint8Array(new ArrayBuffer(32));
+        o.set(new Uint8Array(mod.HEAPU8.buffer, outputPtr, 32));
+        mod._free(inputPtr);
+        mod._free(outputPtr);
+        return o;
+    },
+    dataToHex(data) {
+        const inputPtr = mod._malloc(data.length);
+        new Uint8Array(mod.HEAPU8.buffer, inputPtr, data.length).set(data);
+        const outputPtr = mod.ccall('data_to_hex', 'number', ['number', 'number'], [inputPtr, data.length]);
+        const result = mod.UTF8ToString(outputPtr);
+        mod._free(inputPtr);
+        mod.ccall('scratch_reset', null, [], []);
+        return result;
+    },
+    hexToData(hex) {
+        const utf8 = new TextEncoder().encode(hex);
+        const inputPtr = mod._malloc(utf8.length);
+        new Uint8Array(mod.HEAPU8.buffer, inputPtr, utf8.length).set(utf8);
+        const outputPtrPtr = mod._malloc(4);
+        const outputLenPtr = mod._malloc(4);
+        const success = mod.ccall('hex_to_data', 'boolean', ['number', 'number', 'number', 'number'], [inputPtr, utf8.length, outputPtrPtr, outputLenPtr]);
+        let result = null;
+        if(success) {
+            const outputLen = new Uint32Array(mod.HEAPU8.buffer, outputLenPtr, 1)[0];
+            const outputPtr = new Uint32Array(mod.HEAPU8.buffer, outputPtrPtr, 1)[0];
+            result = new Uint8Array(new ArrayBuffer(outputLen));
+            result.set(new Uint8Array(mod.HEAPU8.buffer, outputPtr, outputLen));
+        }
+        mod._free(inputPtr);
+        mod._free(outputLenPtr);
+        mod._free(outputPtrPtr);
+        mod.ccall('scratch_reset', null, [], []);
+        return result;
+    },
+    reverse(a) {
+        const ptr = mod._malloc(a.length * 4);
+        const base = ptr / 4;
+        const aa = new Int32Array(a);
+        for(let i = 0; i < a.length; i++) {
+            mod.HEAP32[base + i] = aa[i];
+        }
+        mod.ccall('reverse', null, ['number', 'number'], [ptr, a.length]);
+        const result = [];
+        for(let i = 0; i < a.length; i++) {
+            result.push(mod.HEAP32[base + i]);
+        }
+        mod._free(ptr);
+        return result;
+    },
+};
+
+function bytes(n) {
+    const data = new Uint8Array(n);
+    for(let i = 0; i < n; i++) {
+        data[i] = (i * 131 + 7) & 0xff;
+    }
+    return data;
+}
+
+function time(fn, arg) {
+    let iterations = 1;
+    for(;;) {
+        const start = performance.now();
+        for(let i = 0; i < iterations; i++) {
+            fn(arg);
+        }
+        const elapsed = performance.now() - start;
+        if(elapsed > 200) {
+            return elapsed * 1e6 / iterations;
+        }
+        iterations *= 2;
+    }
+}
+
+const cases = [];
+for(const size of [16, 256, 4096, 65536]) {
+    const data = bytes(size);
+    const text = 'x'.repeat(size);
+    const hex = mod.dataToHex(data);
+    const ints = Array.from({ length: size / 4 }, (_, i) => i);
+    cases.push(['sha256', size, text], ['dataToHex', size, data], ['hexToData', size, hex], ['reverse', size, ints]);
+}
+
+console.log('wrapper      bytes    before ns/op   after ns/op   speedup');
+for(const [name, size, arg] of cases) {
+    const b = time(before[name], arg);
+    const a = time(mod[name].bind(mod), arg);
+    console.log(`${name.padEnd(10)} ${String(size).padStart(7)} ${b.toFixed(0).padStart(15)} ${a.toFixed(0).padStart(13)} ${(b / a).toFixed(2).padStart(9)}x`);
+}
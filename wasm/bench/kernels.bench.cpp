@@ -0,0 +1,342 @@
+// Native benchmark suite for the kernels behind the wasm exports.
+//
+// Links hello.cpp itself, so every case calls the same extern "C" entry
+// point that kernels.bench.mjs calls inside the emcc-built module. Each
+// case runs over a size sweep and, where it makes sense, a thread sweep,
+// and the results are printed as JSON for compare.mjs:
+//
+//   { "suite": "hello-kernels", "runtime": "native", ...,
+//     "results": [ { "kernel", "layer", "size", "threads",
+//                    "iterations", "ns_per_op", "gb_per_s" }, ... ] }
+//
+// ns_per_op is the latency of one call on one thread; gb_per_s is the
+// aggregate input throughput of all threads. sha256_tree is the exception:
+// one caller hashes with sha256_Tree on a pool of `threads` workers (the
+// export itself uses the shared, machine-sized pool), and so is
+// cdc_sha256, which chunks on the caller and hashes chunks on the pool;
+// cdc_cut is the chunking stage alone.
+//
+// The typed array cases (array_<op>_<type>) run each typed_array.hpp
+// export on one element type, next to the standard library loop it stands
+// in for (std_<op>_<type>: std::reverse, std::minmax_element,
+// std::accumulate, std::partial_sum, and a plain byte swap loop), compiled
+// for the baseline target of the build.
+//
+//   rogo bench                        (writes build/native.json)
+//   build/kernels.bench [--quick] [--min-time=SEC] [--max-size=BYTES]
+//                       [--threads=1,2,4] [--filter=SUBSTRING] > native.json
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../cpu.hpp"
+#include "../hex.hpp"
+#include "../memzero.hpp"
+#include "../sha256.hpp"
+#include "../sha256_cdc.hpp"
+#include "../sha256_tree.hpp"
+#include "../thread_pool.hpp"
+#include "../typed_array.hpp"
+
+extern "C" {
+void reverse(int32_t* p, size_t len);
+void sha256(const uint8_t* data, size_t len, uint8_t* digest);
+void sha256d(const uint8_t* data, size_t len, uint8_t* digest);
+void sha256_batch(const uint8_t* const* msgs, const size_t* lens, size_t n, uint8_t* digests);
+void hmac_sha256(const uint8_t* key, size_t keylen, const uint8_t* msg, size_t msglen, uint8_t* mac);
+void data_to_hex_into(const uint8_t* data, size_t len, char* out);
+int hex_to_data_into(const char* hex, size_t len, uint8_t* out, size_t* error_pos);
+bool array_reverse(void* p, size_t n, int type);
+bool array_bswap(void* p, size_t n, int type);
+bool array_minmax(const void* p, size_t n, int type, void* out);
+bool array_sum(const void* p, size_t n, int type, void* out);
+bool array_prefix_sum(void* p, size_t n, int type);
+}
+
+using namespace Hello;
+
+#define BENCH_BATCH_MESSAGE 64
+#define BENCH_TREE_LEAF (64 * 1024)
+// cdc_sha256 feeds its input in updates of this size, like a file read.
+#define BENCH_CDC_UPDATE (1024 * 1024)
+// Thread sweeps skip cases whose buffers would exceed this in total.
+#define BENCH_MEMORY_LIMIT ((size_t)1 << 30)
+
+struct Options {
+    double min_time = 0.2;
+    size_t max_size = 64u << 20;
+    std::vector<size_t> threads;
+    std::string filter;
+};
+
+// Buffers for one thread running one case.
+struct Buffers {
+    std::vector<uint8_t> in;
+    std::vector<uint8_t> out;
+    std::vector<const uint8_t*> msgs;
+    std::vector<size_t> lens;
+};
+
+// pool is only set for cases that parallelize internally.
+typedef std::function<void(Buffers&, size_t, ThreadPool* pool)> Kernel;
+
+struct Case {
+    std::string name;
+    size_t out_factor; // bytes of output per input byte
+    bool threaded;     // false: one caller, `threads` pool workers inside
+    Kernel run;
+    std::function<void(Buffers&, size_t)> prepare;
+};
+
+static void fill(std::vector<uint8_t>& v) {
+    for (size_t i = 0; i < v.size(); i++) {
+        v[i] = (uint8_t)(i * 131 + 7);
+    }
+}
+
+// Pseudo-random bytes, for cases where a periodic pattern would skew the
+// result (content-defined chunking finds no boundaries in it, or too many).
+static void fill_random(Buffers& b, size_t) {
+    uint64_t x = 0x2545f4914f6cdd1dull;
+    for (uint8_t& byte : b.in) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        byte = (uint8_t)(x >> 32);
+    }
+}
+
+template <typename T> static void bswap_loop(T* p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        uint8_t bytes[sizeof(T)];
+        memcpy(bytes, &p[i], sizeof(T));
+        std::reverse(bytes, bytes + sizeof(T));
+        memcpy(&p[i], bytes, sizeof(T));
+    }
+}
+
+// The five typed array exports on one element type, and their standard
+// library counterparts. Results go to b.out so that nothing is optimized
+// away.
+template <typename T> static void typed_array_cases(std::vector<Case>& list, const std::string& type_name, int type) {
+    auto none = [](Buffers&, size_t) {};
+    auto add = [&](const char* op, Kernel array, Kernel std_loop) {
+        list.push_back({"array_" + std::string(op) + "_" + type_name, 0, true, array, none});
+        list.push_back({"std_" + std::string(op) + "_" + type_name, 0, true, std_loop, none});
+    };
+    add("reverse", [type](Buffers& b, size_t n, ThreadPool*) { array_reverse(b.in.data(), n / sizeof(T), type); },
+        [](Buffers& b, size_t n, ThreadPool*) { std::reverse((T*)b.in.data(), (T*)b.in.data() + n / sizeof(T)); });
+    add("bswap", [type](Buffers& b, size_t n, ThreadPool*) { array_bswap(b.in.data(), n / sizeof(T), type); },
+        [](Buffers& b, size_t n, ThreadPool*) { bswap_loop((T*)b.in.data(), n / sizeof(T)); });
+    add("minmax", [type](Buffers& b, size_t n, ThreadPool*) { array_minmax(b.in.data(), n / sizeof(T), type, b.out.data()); },
+        [](Buffers& b, size_t n, ThreadPool*) {
+            const T* p = (const T*)b.in.data();
+            auto found = std::minmax_element(p, p + n / sizeof(T));
+            memcpy(b.out.data(), &*found.first, sizeof(T));
+            memcpy(b.out.data() + sizeof(T), &*found.second, sizeof(T));
+        });
+    add("sum", [type](Buffers& b, size_t n, ThreadPool*) { array_sum(b.in.data(), n / sizeof(T), type, b.out.data()); },
+        [](Buffers& b, size_t n, ThreadPool*) {
+            const T* p = (const T*)b.in.data();
+            auto sum = std::accumulate(p, p + n / sizeof(T), (typename ArraySum<T>::type)0);
+            memcpy(b.out.data(), &sum, sizeof(sum));
+        });
+    add("prefix_sum", [type](Buffers& b, size_t n, ThreadPool*) { array_prefix_sum(b.in.data(), n / sizeof(T), type); },
+        [](Buffers& b, size_t n, ThreadPool*) { std::partial_sum((T*)b.in.data(), (T*)b.in.data() + n / sizeof(T), (T*)b.in.data()); });
+}
+
+static std::vector<Case> cases() {
+    std::vector<Case> list;
+    auto none = [](Buffers&, size_t) {};
+    list.push_back({"sha256", 0, true, [](Buffers& b, size_t n, ThreadPool*) { sha256(b.in.data(), n, b.out.data()); }, none});
+    list.push_back({"sha256d", 0, true, [](Buffers& b, size_t n, ThreadPool*) { sha256d(b.in.data(), n, b.out.data()); }, none});
+    list.push_back({"sha256_batch", 1, true,
+                    [](Buffers& b, size_t, ThreadPool*) { sha256_batch(b.msgs.data(), b.lens.data(), b.msgs.size(), b.out.data()); },
+                    [](Buffers& b, size_t n) {
+                        for (size_t offset = 0; offset < n; offset += BENCH_BATCH_MESSAGE) {
+                            b.msgs.push_back(b.in.data() + offset);
+                            b.lens.push_back(std::min<size_t>(BENCH_BATCH_MESSAGE, n - offset));
+                        }
+                    }});
+    list.push_back({"sha256_tree", 1, false,
+                    [](Buffers& b, size_t n, ThreadPool* pool) { sha256_Tree(b.in.data(), n, BENCH_TREE_LEAF, b.out.data(), nullptr, pool); },
+                    none});
+    list.push_back({"cdc_cut", 0, true,
+                    [](Buffers& b, size_t n, ThreadPool*) {
+                        static CdcParams params = [] {
+                            CdcParams p;
+                            cdc_Params(SHA256_CDC_MIN_SIZE, SHA256_CDC_AVG_SIZE, SHA256_CDC_MAX_SIZE, &p);
+                            return p;
+                        }();
+                        for (size_t offset = 0; offset < n;) {
+                            offset += cdc_Cut(b.in.data() + offset, n - offset, params);
+                        }
+                    },
+                    fill_random});
+    list.push_back({"cdc_sha256", 0, false,
+                    [](Buffers& b, size_t n, ThreadPool* pool) {
+                        CdcParams params;
+                        cdc_Params(SHA256_CDC_MIN_SIZE, SHA256_CDC_AVG_SIZE, SHA256_CDC_MAX_SIZE, &params);
+                        Sha256Chunker chunker(params, pool);
+                        for (size_t offset = 0; offset < n; offset += BENCH_CDC_UPDATE) {
+                            chunker.update(b.in.data() + offset, std::min<size_t>(BENCH_CDC_UPDATE, n - offset));
+                        }
+                        chunker.finish();
+                    },
+                    fill_random});
+    list.push_back({"hmac_sha256", 0, true,
+                    [](Buffers& b, size_t n, ThreadPool*) { hmac_sha256(b.in.data(), 32, b.in.data(), n, b.out.data()); }, none});
+    list.push_back({"data_to_hex", 2, true, [](Buffers& b, size_t n, ThreadPool*) { data_to_hex_into(b.in.data(), n, (char*)b.out.data()); }, none});
+    list.push_back({"hex_to_data", 1, true,
+                    [](Buffers& b, size_t n, ThreadPool*) { hex_to_data_into((const char*)b.in.data(), n, b.out.data(), nullptr); },
+                    [](Buffers& b, size_t n) {
+                        std::vector<uint8_t> raw(n / 2);
+                        fill(raw);
+                        data_to_hex(raw.data(), raw.size(), (char*)b.in.data());
+                    }});
+    list.push_back({"reverse", 0, true, [](Buffers& b, size_t n, ThreadPool*) { reverse((int32_t*)b.in.data(), n / 4); }, none});
+    list.push_back({"memzero", 0, true, [](Buffers& b, size_t n, ThreadPool*) { memzero(b.in.data(), n); }, none});
+    typed_array_cases<uint8_t>(list, "u8", TYPED_ARRAY_U8);
+    typed_array_cases<uint16_t>(list, "u16", TYPED_ARRAY_U16);
+    typed_array_cases<uint32_t>(list, "u32", TYPED_ARRAY_U32);
+    typed_array_cases<uint64_t>(list, "u64", TYPED_ARRAY_U64);
+    typed_array_cases<float>(list, "f32", TYPED_ARRAY_F32);
+    typed_array_cases<double>(list, "f64", TYPED_ARRAY_F64);
+    return list;
+}
+
+// Runs the case on `threads` threads with the same iteration count each,
+// doubling the count until the slowest run takes min_time.
+static void measure(const Case& c, size_t size, size_t threads, const Options& options, bool* first) {
+    size_t workers = c.threaded ? threads : 1;
+    std::vector<Buffers> buffers(workers);
+    for (Buffers& b : buffers) {
+        b.in.resize(std::max<size_t>(size, 32));
+        fill(b.in);
+        b.out.resize(std::max<size_t>(size * c.out_factor, 32) + SHA256_DIGEST_LENGTH * (size / BENCH_BATCH_MESSAGE + 1));
+        c.prepare(b, size);
+    }
+    std::unique_ptr<ThreadPool> pool(c.threaded ? nullptr : new ThreadPool(threads));
+
+    size_t iterations = 1;
+    double seconds = 0;
+    for (;;) {
+        std::atomic<size_t> ready(0);
+        std::vector<std::thread> running;
+        auto body = [&](size_t t) {
+            ready++;
+            while (ready.load() < workers) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < iterations; i++) {
+                c.run(buffers[t], size, pool.get());
+            }
+        };
+        auto start = std::chrono::steady_clock::now();
+        for (size_t t = 1; t < workers; t++) {
+            running.emplace_back(body, t);
+        }
+        body(0);
+        for (std::thread& thread : running) {
+            thread.join();
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds >= options.min_time || iterations >= ((size_t)1 << 40)) {
+            break;
+        }
+        iterations *= (seconds > options.min_time / 16) ? 2 : 8;
+    }
+
+    double ns_per_op = seconds * 1e9 / iterations;
+    double gb_per_s = (double)size * iterations * workers / seconds / 1e9;
+    printf("%s    {\"kernel\": \"%s\", \"layer\": \"raw\", \"size\": %zu, \"threads\": %zu, \"iterations\": %zu, "
+           "\"ns_per_op\": %.1f, \"gb_per_s\": %.4f}",
+           *first ? "" : ",\n", c.name.c_str(), size, threads, iterations, ns_per_op, gb_per_s);
+    *first = false;
+    fflush(stdout);
+}
+
+static Options parse(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--quick") == 0) {
+            options.min_time = 0.02;
+            options.max_size = 4u << 20;
+        } else if (strncmp(arg, "--min-time=", 11) == 0) {
+            options.min_time = atof(arg + 11);
+        } else if (strncmp(arg, "--max-size=", 11) == 0) {
+            options.max_size = strtoull(arg + 11, nullptr, 10);
+        } else if (strncmp(arg, "--filter=", 9) == 0) {
+            options.filter = arg + 9;
+        } else if (strncmp(arg, "--threads=", 10) == 0) {
+            for (const char* p = arg + 10; *p;) {
+                char* end;
+                size_t t = strtoul(p, &end, 10);
+                if (t > 0) {
+                    options.threads.push_back(t);
+                }
+                p = (*end == ',') ? end + 1 : end + (*end != 0);
+            }
+        } else {
+            fprintf(stderr, "usage: kernels.bench [--quick] [--min-time=SEC] [--max-size=BYTES] [--threads=1,2,4] [--filter=SUBSTRING]\n");
+            exit(2);
+        }
+    }
+    if (options.threads.empty()) {
+        size_t hw = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+        for (size_t t = 1; t < hw; t *= 2) {
+            options.threads.push_back(t);
+        }
+        options.threads.push_back(hw);
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
+    Options options = parse(argc, argv);
+    static const char* sha256_backends[] = {"portable", "sha-ni", "armv8"};
+    static const char* hex_backends[] = {"scalar", "ssse3", "avx2", "simd128"};
+    static const char* typed_array_backends[] = {"scalar", "avx2", "simd128"};
+
+    printf("{\n  \"suite\": \"hello-kernels\",\n  \"runtime\": \"native\",\n");
+#if defined(__clang__)
+    printf("  \"compiler\": \"clang %s\",\n", __clang_version__);
+#elif defined(__GNUC__)
+    printf("  \"compiler\": \"gcc %s\",\n", __VERSION__);
+#endif
+    printf("  \"hardware_threads\": %u,\n", std::thread::hardware_concurrency());
+    printf("  \"sha256_backend\": \"%s\",\n", sha256_backends[sha256_Backend()]);
+    printf("  \"hex_backend\": \"%s\",\n", hex_backends[hex_backend()]);
+    printf("  \"typed_array_backend\": \"%s\",\n", typed_array_backends[typed_array_backend()]);
+    printf("  \"results\": [\n");
+
+    bool first = true;
+    for (const Case& c : cases()) {
+        if (!options.filter.empty() && strstr(c.name.c_str(), options.filter.c_str()) == nullptr) {
+            continue;
+        }
+        for (size_t size = 16; size <= options.max_size; size *= 4) {
+            for (size_t threads : options.threads) {
+                size_t footprint = (c.threaded ? threads : 1) * size * (1 + c.out_factor);
+                if (threads > 1 && footprint > BENCH_MEMORY_LIMIT) {
+                    continue;
+                }
+                measure(c, size, threads, options, &first);
+            }
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,247 @@
+// wasm counterpart of kernels.bench.cpp.
+//
+// Runs the same cases over the same size sweep against the emcc-built
+// module, in two layers:
+//
+//   raw      the exported function (mod._sha256 etc.) on buffers that were
+//            allocated on the wasm heap up front, like the native suite
+//   wrapped  the hello.post.js wrapper (mod.sha256 etc.) on a JS
+//            typed array or string, so copies in and out count
+//
+// native raw vs. wasm raw is the compiler/runtime gap; wasm raw vs. wasm
+// wrapped is the marshalling cost. The JSON has the same shape as the
+// native suite's, so compare.mjs can line the files up.
+//
+//   node bench/kernels.bench.mjs [--dir=../src/lib/wasm] [--flavor=baseline|simd] [--quick]
+//        [--min-time=SEC] [--max-size=BYTES] [--filter=SUBSTRING] > wasm.json
+//
+// memzero is not exported, so it only appears in the native results. A
+// pthreads build hashes sha256_tree on the shared pool; its results are
+// reported with threads = the pool size.
+
+import os from 'node:os';
+import path from 'node:path';
+import { pathToFileURL } from 'node:url';
+
+const BENCH_BATCH_MESSAGE = 64;
+const BENCH_TREE_LEAF = 64 * 1024;
+const BENCH_CDC_UPDATE = 1024 * 1024;
+
+const options = { dir: '../src/lib/wasm', flavor: undefined, minTime: 0.2, maxSize: 64 << 20, filter: '' };
+for(const arg of process.argv.slice(2)) {
+    const [name, value] = arg.split('=');
+    if(name === '--quick') {
+        options.minTime = 0.02;
+        options.maxSize = 4 << 20;
+    } else if(name === '--dir') {
+        options.dir = value;
+    } else if(name === '--flavor') {
+        options.flavor = value;
+    } else if(name === '--min-time') {
+        options.minTime = Number(value);
+    } else if(name === '--max-size') {
+        options.maxSize = Number(value);
+    } else if(name === '--filter') {
+        options.filter = value;
+    } else {
+        console.error('usage: kernels.bench.mjs [--dir=DIR] [--flavor=baseline|simd] [--quick] [--min-time=SEC] [--max-size=BYTES] [--filter=SUBSTRING]');
+        process.exit(2);
+    }
+}
+
+const dir = path.resolve(options.dir);
+const { default: instantiate_hello, helloFlavor } = await import(pathToFileURL(path.join(dir, 'hello.loader.js')));
+const flavor = options.flavor ?? helloFlavor();
+const mod = await instantiate_hello({}, flavor);
+const shared = typeof SharedArrayBuffer !== 'undefined' && mod.HEAPU8.buffer instanceof SharedArrayBuffer;
+const poolThreads = shared ? os.availableParallelism() : 1;
+
+function bytes(n) {
+    const data = new Uint8Array(n);
+    for(let i = 0; i < n; i++) {
+        data[i] = (i * 131 + 7) & 0xff;
+    }
+    return data;
+}
+
+// Heap buffers for one raw case; the inputs are copied in once.
+function heap(data, outLen) {
+    const inPtr = mod._malloc(Math.max(data.length, 32));
+    const outPtr = mod._malloc(Math.max(outLen, 32));
+    mod.HEAPU8.set(data, inPtr);
+    return { inPtr, outPtr, free() { mod._free(inPtr); mod._free(outPtr); } };
+}
+
+// Pseudo-random bytes (same generator as the native suite), for chunking.
+function randomBytes(n) {
+    const data = new Uint8Array(n);
+    let x = 0x2545f4914f6cdd1dn;
+    for(let i = 0; i < n; i++) {
+        x ^= (x << 13n) & 0xffffffffffffffffn;
+        x ^= x >> 7n;
+        x ^= (x << 17n) & 0xffffffffffffffffn;
+        data[i] = Number((x >> 32n) & 0xffn);
+    }
+    return data;
+}
+
+function messages(data) {
+    const msgs = [];
+    for(let offset = 0; offset < data.length; offset += BENCH_BATCH_MESSAGE) {
+        msgs.push(data.subarray(offset, offset + BENCH_BATCH_MESSAGE));
+    }
+    return msgs;
+}
+
+// The typed array cases, as in the native suite: [name, array type, type
+// code] and [export suffix, mod.typedArray method]. The wrapped layer
+// passes a JS array, so it pays for the copy in and out.
+const typedArrayTypes = [
+    ['u8', Uint8Array, 0], ['u16', Uint16Array, 1], ['u32', Uint32Array, 2], ['u64', BigUint64Array, 3],
+    ['f32', Float32Array, 8], ['f64', Float64Array, 9],
+];
+const typedArrayOps = [['reverse', 'reverse'], ['bswap', 'byteSwap'], ['minmax', 'minMax'], ['sum', 'sum'], ['prefix_sum', 'prefixSum']];
+
+// Each case returns { raw, wrapped, free } closures for one size.
+const cases = [
+    ['sha256', (data) => {
+        const h = heap(data, 32);
+        return { raw: () => mod._sha256(h.inPtr, data.length, h.outPtr), wrapped: () => mod.sha256(data), free: h.free };
+    }],
+    ['sha256d', (data) => {
+        const h = heap(data, 32);
+        return { raw: () => mod._sha256d(h.inPtr, data.length, h.outPtr), wrapped: () => mod.sha256d(data), free: h.free };
+    }],
+    ['sha256_batch', (data) => {
+        const msgs = messages(data);
+        const n = msgs.length;
+        const h = heap(data, n * 8 + n * 32);
+        const tables = h.outPtr >> 2;
+        for(let i = 0; i < n; i++) {
+            mod.HEAPU32[tables + i] = h.inPtr + i * BENCH_BATCH_MESSAGE;
+            mod.HEAPU32[tables + n + i] = msgs[i].length;
+        }
+        return {
+            raw: () => mod._sha256_batch(h.outPtr, h.outPtr + n * 4, n, h.outPtr + n * 8),
+            wrapped: () => mod.sha256Batch(msgs),
+            free: h.free,
+        };
+    }],
+    ['sha256_tree', (data) => {
+        const h = heap(data, 32);
+        return {
+            raw: () => mod._sha256_tree(h.inPtr, data.length, BENCH_TREE_LEAF, h.outPtr, 0),
+            wrapped: () => mod.sha256Tree(data, BENCH_TREE_LEAF),
+            free: h.free,
+        };
+    }],
+    ['cdc_sha256', (periodic) => {
+        const data = randomBytes(periodic.length);
+        const h = heap(data, 8);
+        const feed = (update) => {
+            for(let offset = 0; offset < data.length; offset += BENCH_CDC_UPDATE) {
+                update(offset, Math.min(BENCH_CDC_UPDATE, data.length - offset));
+            }
+        };
+        const chunker = mod._chunker_create(16 * 1024, 64 * 1024, 256 * 1024);
+        const wrapped = new mod.Chunker();
+        return {
+            raw: () => {
+                feed((offset, n) => mod._chunker_update(chunker, h.inPtr + offset, n));
+                mod._chunker_finish(chunker, h.outPtr);
+            },
+            wrapped: () => {
+                feed((offset, n) => wrapped.update(data.subarray(offset, offset + n)));
+                wrapped.finish();
+            },
+            free: () => {
+                mod._chunker_destroy(chunker);
+                wrapped.destroy();
+                h.free();
+            },
+        };
+    }],
+    ['hmac_sha256', (data) => {
+        const h = heap(data, 32);
+        const key = data.subarray(0, 32);
+        return {
+            raw: () => mod._hmac_sha256(h.inPtr, 32, h.inPtr, data.length, h.outPtr),
+            wrapped: () => mod.hmacSha256(key, data),
+            free: h.free,
+        };
+    }],
+    ['data_to_hex', (data) => {
+        const h = heap(data, data.length * 2);
+        return { raw: () => mod._data_to_hex_into(h.inPtr, data.length, h.outPtr), wrapped: () => mod.dataToHex(data), free: h.free };
+    }],
+    ['hex_to_data', (data) => {
+        const hex = mod.dataToHex(data.subarray(0, data.length >> 1));
+        const h = heap(new TextEncoder().encode(hex), data.length >> 1);
+        return {
+            raw: () => mod._hex_to_data_into(h.inPtr, hex.length, h.outPtr, 0),
+            wrapped: () => mod.hexToData(hex),
+            free: h.free,
+        };
+    }],
+    ['reverse', (data) => {
+        const ints = new Int32Array(data.buffer, 0, data.length >> 2);
+        const h = heap(data, 0);
+        return { raw: () => mod._reverse(h.inPtr, ints.length), wrapped: () => mod.reverse(ints), free: h.free };
+    }],
+    ...typedArrayTypes.flatMap(([name, Type, type]) => typedArrayOps.map(([op, method]) => [`array_${op}_${name}`, (data) => {
+        const array = new Type(data.buffer, 0, data.length / Type.BYTES_PER_ELEMENT);
+        const h = heap(data, 16);
+        const kernel = mod[`_array_${op}`];
+        return { raw: () => kernel(h.inPtr, array.length, type, h.outPtr), wrapped: () => mod.typedArray[method](array), free: h.free };
+    }])),
+];
+
+// Doubles the iteration count until one run takes minTime, as the native
+// suite does.
+function measure(fn) {
+    let iterations = 1;
+    for(;;) {
+        const start = performance.now();
+        for(let i = 0; i < iterations; i++) {
+            fn();
+        }
+        const seconds = (performance.now() - start) / 1000;
+        if(seconds >= options.minTime) {
+            return { iterations, seconds };
+        }
+        iterations *= seconds > options.minTime / 16 ? 2 : 8;
+    }
+}
+
+const results = [];
+for(const [kernel, setup] of cases) {
+    if(options.filter && !kernel.includes(options.filter)) {
+        continue;
+    }
+    const threads = kernel === 'sha256_tree' || kernel === 'cdc_sha256' ? poolThreads : 1;
+    for(let size = 16; size <= options.maxSize; size *= 4) {
+        const run = setup(bytes(size));
+        try {
+            for(const layer of ['raw', 'wrapped']) {
+                const { iterations, seconds } = measure(run[layer]);
+                results.push({
+                    kernel, layer, size, threads, iterations,
+                    ns_per_op: Number((seconds * 1e9 / iterations).toFixed(1)),
+                    gb_per_s: Number((size * iterations / seconds / 1e9).toFixed(4)),
+                });
+            }
+        } finally {
+            run.free();
+        }
+    }
+}
+
+console.log(JSON.stringify({
+    suite: 'hello-kernels',
+    runtime: 'wasm',
+    flavor,
+    pthreads: shared,
+    node: process.version,
+    hardware_threads: os.availableParallelism(),
+    results,
+}, null, 2));
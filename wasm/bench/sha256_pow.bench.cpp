@@ -0,0 +1,117 @@
+// Proof-of-work benchmark: hash rate of sha256_PowSearch against hashing
+// every nonce from scratch, the way a JS loop over Module.sha256 does.
+//
+// Three measurements:
+//
+//   naive    per nonce, allocate prefix || nonce, copy and sha256_Raw it
+//   search   sha256_PowSearch over a range no nonce can solve (256 bits),
+//            for each thread count: hashes per second, per core, and the
+//            speedup over one thread
+//   solve    one real search at --bits on the largest thread count
+//
+//   rogo bench_pow
+//   build/sha256_pow.bench [--prefix=BYTES] [--bits=N] [--hashes=N] [--threads=1,2,4]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../sha256.hpp"
+#include "../sha256_pow.hpp"
+#include "../thread_pool.hpp"
+
+using namespace Hello;
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t prefix_len = 64;
+    unsigned bits = 24;
+    uint64_t hashes = 1 << 22;
+    std::vector<size_t> threads;
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--prefix=", 9)) {
+            prefix_len = strtoul(argv[i] + 9, nullptr, 10);
+        } else if (!strncmp(argv[i], "--bits=", 7)) {
+            bits = (unsigned)strtoul(argv[i] + 7, nullptr, 10);
+        } else if (!strncmp(argv[i], "--hashes=", 9)) {
+            hashes = strtoull(argv[i] + 9, nullptr, 10);
+        } else if (!strncmp(argv[i], "--threads=", 10)) {
+            for (const char* p = argv[i] + 10; *p;) {
+                char* end;
+                size_t t = strtoul(p, &end, 10);
+                if (t > 0) {
+                    threads.push_back(t);
+                }
+                p = (*end == ',') ? end + 1 : end + (*end != 0);
+            }
+        } else {
+            fprintf(stderr, "usage: sha256_pow.bench [--prefix=BYTES] [--bits=N] [--hashes=N] [--threads=1,2,4]\n");
+            return 1;
+        }
+    }
+    if (threads.empty()) {
+        size_t hw = std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+        for (size_t t = 1; t < hw; t *= 2) {
+            threads.push_back(t);
+        }
+        threads.push_back(hw);
+    }
+
+    std::vector<uint8_t> prefix(prefix_len);
+    for (size_t i = 0; i < prefix_len; i++) {
+        prefix[i] = (uint8_t)(i * 131 + 7);
+    }
+    static const char* backends[] = {"portable", "sha-ni", "armv8"};
+    printf("prefix        %zu bytes, %zu final block(s) per nonce\n", prefix_len,
+           (prefix_len % SHA256_BLOCK_LENGTH) + SHA256_POW_NONCE_LENGTH + 9 <= SHA256_BLOCK_LENGTH ? (size_t)1 : (size_t)2);
+    printf("backend       %s\n", backends[sha256_Backend()]);
+
+    uint64_t naive_count = hashes / 8 ? hashes / 8 : 1;
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    static volatile uint8_t sink;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t nonce = 0; nonce < naive_count; nonce++) {
+        uint8_t* message = (uint8_t*)malloc(prefix_len + SHA256_POW_NONCE_LENGTH);
+        memcpy(message, prefix.data(), prefix_len);
+        for (int i = 0; i < SHA256_POW_NONCE_LENGTH; i++) {
+            message[prefix_len + i] = (uint8_t)(nonce >> (56 - 8 * i));
+        }
+        sha256_Raw(message, prefix_len + SHA256_POW_NONCE_LENGTH, digest);
+        free(message);
+        sink = sink ^ digest[0];
+    }
+    double naive = (double)naive_count / seconds_since(start);
+    printf("naive         %.2f MH/s (one thread)\n", naive / 1e6);
+
+    printf("threads   MH/s      per core  speedup\n");
+    double single = 0;
+    for (size_t t : threads) {
+        ThreadPool pool(t);
+        Sha256PowResult result;
+        sha256_PowSearch(prefix.data(), prefix_len, SHA256_POW_MAX_BITS, 0, hashes, &result, &pool);
+        double rate = (double)result.hashes / result.seconds;
+        if (single == 0) {
+            single = rate / (double)result.threads;
+        }
+        printf("%-9u %-9.2f %-9.2f x%.2f\n", result.threads, rate / 1e6, rate / result.threads / 1e6, rate / single);
+    }
+
+    ThreadPool pool(threads.back());
+    Sha256PowResult result;
+    if (sha256_PowSearch(prefix.data(), prefix_len, bits, 0, UINT64_MAX, &result, &pool)) {
+        printf("solve         %u bits: nonce %llu after %llu hashes, %.3f s on %u threads (%.2f MH/s per core)\n", bits,
+               (unsigned long long)result.nonce, (unsigned long long)result.hashes, result.seconds, result.threads,
+               (double)result.hashes / result.seconds / result.threads / 1e6);
+    } else {
+        printf("solve         %u bits: no solution\n", bits);
+    }
+    return 0;
+}
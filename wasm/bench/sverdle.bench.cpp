@@ -0,0 +1,123 @@
+// Sverdle solver benchmark: solves every answer in the words list and
+// reports the total time, the guess distribution and the memory it took.
+//
+// Three timings are reported: building the whole feedback matrix, the
+// opening guess (a full entropy pass over every answer) and the games
+// themselves, which start from the cached opening and reuse each cached
+// second guess. --threads sets the size of the pool the entropy passes run
+// on (0, the default, sizes it to the machine). --words maps a word table
+// written by sverdle.words.mjs --bin instead of using the linked-in one.
+//
+//   rogo bench_sverdle
+//   build/sverdle.bench [--threads=N] [--limit=ANSWERS] [--words=FILE]
+//
+// The same file builds with emcc and runs under node; there the pool has
+// no workers unless the module was built with pthreads.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#if !defined(__EMSCRIPTEN__) && defined(__unix__)
+#include <sys/resource.h>
+#endif
+
+#include "../sverdle.hpp"
+#include "../sverdle_solver.hpp"
+#include "../thread_pool.hpp"
+
+using namespace Hello;
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Peak resident set in bytes, or 0 where it cannot be asked for.
+static size_t peak_rss() {
+#if !defined(__EMSCRIPTEN__) && defined(__unix__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return (size_t)usage.ru_maxrss * 1024;
+    }
+#endif
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    size_t threads = 0;
+    size_t limit = (size_t)-1;
+    const char* words = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--threads=", 10)) {
+            threads = strtoul(argv[i] + 10, nullptr, 10);
+        } else if (!strncmp(argv[i], "--limit=", 8)) {
+            limit = strtoul(argv[i] + 8, nullptr, 10);
+        } else if (!strncmp(argv[i], "--words=", 8)) {
+            words = argv[i] + 8;
+        } else {
+            fprintf(stderr, "usage: sverdle.bench [--threads=N] [--limit=ANSWERS] [--words=FILE]\n");
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (words && !sverdle_Map(words)) {
+        fprintf(stderr, "sverdle.bench: %s is not a word table\n", words);
+        return 1;
+    }
+    double load = seconds_since(start);
+    if (limit > sverdle_AnswerCount()) {
+        limit = sverdle_AnswerCount();
+    }
+
+    ThreadPool pool(threads);
+    SverdleMatrix matrix;
+    SverdleSolver solver(matrix, &pool);
+
+    start = std::chrono::steady_clock::now();
+    pool.parallel_for((matrix.guesses() + SVERDLE_MATRIX_BLOCK - 1) / SVERDLE_MATRIX_BLOCK,
+                      [&](size_t block) { matrix.row(block * SVERDLE_MATRIX_BLOCK); });
+    double build = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    double entropy = 0;
+    char opening[SVERDLE_LETTERS + 1] = {0};
+    sverdle_Unpack(solver.best(&entropy), opening);
+    double first = seconds_since(start);
+
+    size_t turns[SVERDLE_MAX_TURNS + 1] = {0};
+    size_t total = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t a = 0; a < limit; a++) {
+        int n = solver.solve(a);
+        turns[n]++;
+        total += (size_t)n;
+    }
+    double games = seconds_since(start);
+
+    printf("answers       %zu of %zu (guesses: %zu)\n", limit, matrix.answers(), matrix.guesses());
+    printf("threads       %zu\n", pool.size() ? pool.size() : (size_t)1);
+    if (words) {
+        printf("word table    %zu bytes, mapped from %s in %.3f ms\n", sverdle_WordsSize(), words, load * 1e3);
+    } else {
+        printf("word table    %zu bytes, linked in\n", sverdle_WordsSize());
+    }
+    printf("matrix build  %.3f s, %.1f MB\n", build, matrix.bytes() / 1e6);
+    printf("opening       %s, %.4f bits, %.3f s\n", opening, entropy, first);
+    printf("games         %.3f s total, %.3f ms per answer\n", games, limit ? games * 1e3 / (double)limit : 0.0);
+    printf("guesses       %.4f on average, %zu unsolved\n", limit ? (double)total / (double)(limit - turns[0]) : 0.0,
+           turns[0]);
+    printf("distribution ");
+    for (int n = 1; n <= SVERDLE_MAX_TURNS; n++) {
+        if (turns[n]) {
+            printf(" %d:%zu", n, turns[n]);
+        }
+    }
+    printf("\n");
+    if (size_t rss = peak_rss()) {
+        printf("peak rss      %.1f MB\n", rss / 1e6);
+    }
+    return turns[0] ? 1 : 0;
+}
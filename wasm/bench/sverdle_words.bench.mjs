@@ -0,0 +1,88 @@
+// Cold start and resident memory of the Sverdle word lists: the TypeScript
+// module the game used to import (a 13k-line array literal parsed, turned
+// into strings and copied into a Set) against the word table linked into
+// the hello module (sverdle.words.mjs). Each sample is a fresh Node process
+// that loads the words and answers its first lookup:
+//
+//   ready     import (and for wasm, instantiate) until lookups can start
+//   first     the first allowed('crane') lookup
+//   rss       resident memory added by loading, after a full GC
+//   heap      JS heap added by loading, after a full GC
+//
+// The wasm figures cover the whole module (every kernel, the table and the
+// initial heap), not the table alone.
+//
+//   node bench/sverdle_words.bench.mjs [--runs=N] [--words=words.server.ts] [wasm dir ...]
+
+import { execFileSync } from 'node:child_process';
+import fs from 'node:fs';
+import os from 'node:os';
+import path from 'node:path';
+import { pathToFileURL } from 'node:url';
+
+let runs = 15;
+let wordsPath = path.resolve('../src/routes/sverdle/words.server.ts');
+const dirs = [];
+for(const arg of process.argv.slice(2)) {
+    if(arg.startsWith('--runs=')) {
+        runs = Number(arg.slice(7));
+    } else if(arg.startsWith('--words=')) {
+        wordsPath = path.resolve(arg.slice(8));
+    } else {
+        dirs.push(path.resolve(arg));
+    }
+}
+if(!dirs.length) {
+    dirs.push(path.resolve('../src/lib/wasm'));
+}
+
+// words.server.ts is plain JavaScript apart from its extension; a copy
+// with .mjs imports without a TypeScript loader.
+const tmp = fs.mkdtempSync(path.join(os.tmpdir(), 'sverdle-words-'));
+const wordsModule = path.join(tmp, 'words.mjs');
+fs.copyFileSync(wordsPath, wordsModule);
+
+// Runs in the child (with --expose-gc); `load` resolves to a lookup
+// function. Prints [ready ms, first ms, rss bytes, heap bytes].
+const probe = (load) => `
+gc();
+const before = process.memoryUsage();
+const t0 = performance.now();
+const allowed = await (${load})();
+const t1 = performance.now();
+allowed('crane');
+const t2 = performance.now();
+gc();
+const after = process.memoryUsage();
+console.log(JSON.stringify([t1 - t0, t2 - t1, after.rss - before.rss, after.heapUsed - before.heapUsed]));
+`;
+
+const cases = [
+    ['words.server.ts', `async () => {
+        const { allowed } = await import(${JSON.stringify(pathToFileURL(wordsModule).href)});
+        return (word) => allowed.has(word);
+    }`],
+    ...dirs.map((dir) => [path.relative(process.cwd(), dir) || '.', `async () => {
+        const { default: instantiate_hello } = await import(${JSON.stringify(pathToFileURL(path.join(dir, 'hello.loader.js')).href)});
+        const { sverdle } = await instantiate_hello();
+        return (word) => sverdle.allowed(word);
+    }`]),
+];
+
+const median = (values) => values.slice().sort((a, b) => a - b)[values.length >> 1];
+const mb = (bytes) => (bytes / 1e6).toFixed(2);
+
+console.log('words'.padEnd(40) + 'ready ms'.padStart(10) + 'first ms'.padStart(10) + 'rss MB'.padStart(10) + 'heap MB'.padStart(10));
+try {
+    for(const [name, load] of cases) {
+        const samples = [];
+        for(let i = 0; i < runs; i++) {
+            const out = execFileSync(process.execPath, ['--expose-gc', '--input-type=module', '-e', probe(load)], { encoding: 'utf8' });
+            samples.push(JSON.parse(out.trim().split('\n').pop()));
+        }
+        const [ready, first, rss, heap] = [0, 1, 2, 3].map((k) => median(samples.map((s) => s[k])));
+        console.log(name.padEnd(40) + ready.toFixed(2).padStart(10) + first.toFixed(3).padStart(10) + mb(rss).padStart(10) + mb(heap).padStart(10));
+    }
+} finally {
+    fs.rmSync(tmp, { recursive: true, force: true });
+}
@@ -0,0 +1,53 @@
+// Generates hello.bindings.js, the direct export bindings hello.post.js
+// uses instead of cwrap, from the EMSCRIPTEN_KEEPALIVE functions in
+// hello.cpp.
+//
+//   node bindings.mjs hello.cpp > hello.bindings.js
+//
+// Every export takes and returns plain numbers, so most bindings are the
+// wasm export itself with nothing in between. Only two kinds of result need
+// a conversion: bool comes back as an i32 and becomes a boolean, and
+// pointers and size_t come back as signed i32 and are made unsigned (>>> 0)
+// so addresses above 2 GB stay valid.
+
+import fs from 'node:fs';
+
+const source = fs.readFileSync(process.argv[2] ?? 'hello.cpp', 'utf8');
+const exports = [];
+const pattern = /EMSCRIPTEN_KEEPALIVE\s+((?:const\s+)?[\w:]+\s*\**)\s*(\w+)\s*\(([^)]*)\)\s*\{/g;
+for(const [, returns, name, params] of source.matchAll(pattern)) {
+    const args = params.split(',').map((p) => p.trim()).filter((p) => p && p !== 'void')
+        .map((p) => p.replace(/\[.*\]$/, '').match(/(\w+)$/)[1]);
+    exports.push({ name, returns: returns.replace(/\s+/g, ' ').trim(), args });
+}
+if(!exports.length) {
+    console.error(`bindings.mjs: no EMSCRIPTEN_KEEPALIVE functions in ${process.argv[2]}`);
+    process.exit(1);
+}
+
+function binding({ name, returns, args }) {
+    const list = args.join(', ');
+    const type = `(${args.map((a) => `${a}: number`).join(', ')}) => `;
+    if(returns === 'bool') {
+        return [`${type}boolean`, `(${list}) => _${name}(${list}) !== 0`];
+    }
+    if(returns.endsWith('*') || returns === 'size_t') {
+        return [`${type}number`, `(${list}) => _${name}(${list}) >>> 0`];
+    }
+    return [`${type}${returns === 'void' ? 'void' : 'number'}`, `_${name}`];
+}
+
+const lines = [
+    '// Generated from hello.cpp by bindings.mjs; do not edit.',
+    '',
+    '// Direct bindings to the exports, keyed by C name. Call once the runtime is',
+    '// initialized.',
+    'function helloBindings() {',
+    '    return {',
+];
+for(const e of exports) {
+    const [type, value] = binding(e);
+    lines.push(`        /** @type {${type}} */`, `        ${e.name}: ${value},`);
+}
+lines.push('    };', '}', '');
+process.stdout.write(lines.join('\n'));
@@ -0,0 +1,83 @@
+// Size and startup report for emcc builds, run at the end of build.sh.
+//
+// For each JS glue file the matching .wasm is measured:
+//
+//   bytes     raw and gzip-compressed size of the .wasm
+//   exports   number of wasm exports
+//   compile   WebAssembly.compile of the bytes
+//   inst      WebAssembly.instantiate of the compiled module, with every
+//             import stubbed out
+//   ready     the emcc factory, from reading the file to onRuntimeInitialized;
+//             "-" when the glue was built without node in -sENVIRONMENT
+//
+// Times are the median of several runs, in milliseconds.
+//
+//   node build.report.mjs ../src/lib/wasm/hello.js [more glue files ...]
+
+import fs from 'node:fs';
+import path from 'node:path';
+import zlib from 'node:zlib';
+import { pathToFileURL } from 'node:url';
+
+const RUNS = 7;
+
+async function median(fn) {
+    const times = [];
+    for(let i = 0; i < RUNS; i++) {
+        const start = performance.now();
+        await fn();
+        times.push(performance.now() - start);
+    }
+    times.sort((a, b) => a - b);
+    return times[RUNS >> 1];
+}
+
+function stubs(module) {
+    const imports = {};
+    for(const { module: name, name: field, kind } of WebAssembly.Module.imports(module)) {
+        imports[name] ??= {};
+        if(kind === 'function') {
+            imports[name][field] = () => 0;
+        } else if(kind === 'memory') {
+            imports[name][field] = new WebAssembly.Memory({ initial: 256, maximum: 65536, shared: false });
+        } else if(kind === 'table') {
+            imports[name][field] = new WebAssembly.Table({ initial: 0, element: 'anyfunc' });
+        } else if(kind === 'global') {
+            imports[name][field] = new WebAssembly.Global({ value: 'i32', mutable: true }, 0);
+        }
+    }
+    return imports;
+}
+
+async function ready(glue) {
+    const { default: factory } = await import(pathToFileURL(glue));
+    try {
+        await factory({ print() {}, printErr() {} });
+    } catch {
+        return null;
+    }
+    return median(() => factory({ print() {}, printErr() {} }));
+}
+
+const fmt = (ms) => (ms === null ? '-' : ms.toFixed(2));
+console.log('module'.padEnd(28) + 'bytes'.padStart(10) + 'gzip'.padStart(10) + 'exports'.padStart(9) +
+    'compile'.padStart(10) + 'inst'.padStart(8) + 'ready'.padStart(8));
+for(const glue of process.argv.slice(2).map((p) => path.resolve(p))) {
+    const wasmPath = glue.replace(/\.js$/, '.wasm');
+    const bytes = fs.readFileSync(wasmPath);
+    const module = await WebAssembly.compile(bytes);
+    const compile = await median(() => WebAssembly.compile(bytes));
+    let inst = null;
+    try {
+        const imports = stubs(module);
+        await WebAssembly.instantiate(module, imports);
+        inst = await median(() => WebAssembly.instantiate(module, imports));
+    } catch {
+        // imports whose types the stubs cannot guess
+    }
+    console.log(path.basename(wasmPath).padEnd(28) +
+        String(bytes.length).padStart(10) +
+        String(zlib.gzipSync(bytes, { level: 9 }).length).padStart(10) +
+        String(WebAssembly.Module.exports(module).length).padStart(9) +
+        fmt(compile).padStart(10) + fmt(inst).padStart(8) + fmt(await ready(glue)).padStart(8));
+}
@@ -1,11 +1,84 @@
+# HELLO_PROFILE selects the optimization profile (rogo build <profile>):
+#   debug    -O0 with DWARF and runtime assertions
+#   release  -O3 and LTO; emcc runs wasm-opt on the linked module (default)
+#   size     -Oz and LTO
+#
+# Optimized profiles also pre-initialize the module: -sEVAL_CTORS runs the
+# static constructors at build time (wasm-ctor-eval) and stores the memory
+# they leave behind in the data segments, so startup skips them.
+#
+# The closure compiler (--closure 1) is left out of size: its ADVANCED mode
+# renames unquoted properties, and the API in hello.post.js is written with
+# plain property names (sverdle.enter, { root, leaves }, ...).
+case "${HELLO_PROFILE:-release}" in
+  debug)   OPT_FLAGS="-O0 -g -sASSERTIONS=2" ;;
+  release) OPT_FLAGS="-O3 -flto -sEVAL_CTORS" ;;
+  size)    OPT_FLAGS="-Oz -flto -sEVAL_CTORS" ;;
+  *)       echo "build.sh: unknown HELLO_PROFILE '$HELLO_PROFILE'" >&2; exit 1 ;;
+esac
+
 emcc Hello.c \
+  $OPT_FLAGS \
   -sMODULARIZE \
   -sEXPORT_ES6 \
   -sENVIRONMENT=web \
   -sEXPORTED_FUNCTIONS="['_main','_add','_hello']" \
-  -sEXPORTED_RUNTIME_METHODS="['ccall','cwrap']" \
+  -sEXPORTED_RUNTIME_METHODS="['ccall','cwrap','UTF8ToString']" \
   --post-js WrapFunctions.js \
   -o ../src/routes/warlock/Hello.js
 
 # Typescript Declaration File
 cp Hello.d.ts ../src/routes/warlock
+
+# C++ module, built twice: a baseline binary and a WASM SIMD128 flavor with
+# vectorized SHA-256 message expansion and hex codecs. hello.loader.js picks
+# one at startup.
+#
+# HELLO_PTHREADS=1 builds with pthreads so the thread pool behind tree
+# hashing runs on Web Workers; the page must then be cross-origin isolated.
+if [ -n "$HELLO_PTHREADS" ]; then
+  # wasm-ctor-eval cannot snapshot shared memory
+  OPT_FLAGS=$(echo "$OPT_FLAGS" | sed 's/ -sEVAL_CTORS//')
+  THREAD_FLAGS="-pthread -sPTHREAD_POOL_SIZE=navigator.hardwareConcurrency -sENVIRONMENT=web,worker,node"
+else
+  THREAD_FLAGS="-sENVIRONMENT=web,node"
+fi
+
+# HELLO_STATS=1 compiles in the hot-path counters read by Module.stats().
+if [ -n "$HELLO_STATS" ]; then
+  STATS_FLAGS="-DHELLO_STATS"
+fi
+
+# Direct export bindings for hello.post.js, generated from hello.cpp
+node bindings.mjs hello.cpp > hello.bindings.js
+
+# Packed Sverdle word tables and dictionary hash, generated from the word lists
+node sverdle.words.mjs ../src/routes/sverdle/words.server.ts > sverdle_words.cpp
+
+build_hello() {
+  emcc hello.cpp arena.cpp secure_arena.cpp stats.cpp sha256.cpp sha256_hw.cpp sha256_multi.cpp sha256_fixed.cpp sha256_midstate.cpp sha256_tree.cpp sha256_cdc.cpp hmac_sha256.cpp thread_pool.cpp \
+    hex.cpp hex_simd.cpp memzero.cpp cpu.cpp sverdle.cpp sverdle_solver.cpp sverdle_words.cpp typed_array.cpp sha256_pow.cpp \
+    $OPT_FLAGS \
+    -sMODULARIZE \
+    -sEXPORT_ES6 \
+    $THREAD_FLAGS \
+    $STATS_FLAGS \
+    -sALLOW_MEMORY_GROWTH \
+    -sEXPORTED_FUNCTIONS="['_malloc','_free']" \
+    -sEXPORTED_RUNTIME_METHODS="['ccall','cwrap','UTF8ToString','HEAPU8','HEAP32','HEAPU32']" \
+    --post-js hello.bindings.js \
+    --post-js hello.post.js \
+    "$@"
+}
+
+mkdir -p ../src/lib/wasm
+build_hello -o ../src/lib/wasm/hello.js
+build_hello -msimd128 -o ../src/lib/wasm/hello.simd.js
+cp hello.loader.js hello.async.js hello.async.d.ts hello.worker.js ../src/lib/wasm
+
+# Both flavors must produce identical output, and so must the worker facade
+node hello.flavors.mjs ../src/lib/wasm
+node hello.async.check.mjs ../src/lib/wasm
+
+# Size, export count and startup time of what was just built
+node build.report.mjs ../src/routes/warlock/Hello.js ../src/lib/wasm/hello.js ../src/lib/wasm/hello.simd.js
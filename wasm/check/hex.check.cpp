@@ -0,0 +1,150 @@
+// Checks every hex backend the CPU supports against the scalar table code:
+// encoded digits, decoded bytes, HexStatus and error_pos must all match.
+//
+// Inputs are random bytes of random length, decoded in random case, with
+// random characters (and characters next to the digit ranges: '/', ':',
+// '@', 'G', '`', 'g', 0x80..) written over some of the digits. Every length
+// up to a few vector blocks is also decoded with one bad character at each
+// position, so a bad character in any lane of any block is covered.
+//
+//   rogo check
+//   build/hex.check [--rounds=N] [--seed=N]
+//
+// The same file builds with emcc; with -msimd128 it checks the SIMD128
+// kernels under node.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../hex.hpp"
+
+using namespace Hello;
+
+static const char* backend_names[] = {"scalar", "ssse3", "avx2", "simd128"};
+
+// Characters just outside 0-9, A-F and a-f, and a few high bytes.
+static const char near_digits[] = {'/', ':', '@', 'G', '`', 'g', ' ', '\0', (char)0x80, (char)0xb0, (char)0xc6, (char)0xff};
+
+static void encode(HexBackend backend, const std::vector<uint8_t>& data, std::string& hex) {
+    hex_set_backend(backend);
+    hex.assign(data.size() * 2, '?');
+    data_to_hex(data.data(), data.size(), &hex[0]);
+}
+
+struct Decoded {
+    HexStatus status;
+    size_t error_pos;
+    std::vector<uint8_t> out;
+};
+
+static Decoded decode(HexBackend backend, const std::string& hex) {
+    hex_set_backend(backend);
+    Decoded d;
+    d.error_pos = SIZE_MAX;
+    d.out.assign(hex.size() / 2, 0);
+    d.status = hex_to_data(hex.data(), hex.size(), d.out.data(), &d.error_pos);
+    return d;
+}
+
+// Decodes hex on backend and on the scalar code; prints and returns false
+// on any difference. The output is only compared on success, since it is
+// unspecified after a bad character.
+static bool same_decode(HexBackend backend, const std::string& hex) {
+    Decoded want = decode(HEX_BACKEND_SCALAR, hex);
+    Decoded got = decode(backend, hex);
+    bool ok = got.status == want.status && got.error_pos == want.error_pos && (want.status != HEX_OK || got.out == want.out);
+    if (!ok) {
+        fprintf(stderr, "%s: decode of %zu characters: status %d, error_pos %zu%s; scalar: status %d, error_pos %zu\n",
+                backend_names[backend], hex.size(), got.status, got.error_pos, got.out != want.out ? ", output differs" : "",
+                want.status, want.error_pos);
+    }
+    return ok;
+}
+
+static bool check_backend(HexBackend backend, unsigned long rounds, unsigned long seed) {
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data;
+    std::string want, got;
+
+    for (unsigned long round = 0; round < rounds; round++) {
+        data.resize(rng() % (round % 16 == 0 ? 4096 : 160));
+        for (auto& byte : data) {
+            byte = (uint8_t)rng();
+        }
+        encode(HEX_BACKEND_SCALAR, data, want);
+        encode(backend, data, got);
+        if (got != want) {
+            fprintf(stderr, "%s: encode of %zu bytes differs\n", backend_names[backend], data.size());
+            return false;
+        }
+
+        std::string hex = want;
+        for (auto& c : hex) {
+            if (rng() % 2 && c >= 'a') {
+                c = (char)(c - 'a' + 'A');
+            }
+        }
+        for (unsigned bad = rng() % 3; bad > 0 && !hex.empty(); bad--) {
+            char c = (rng() % 2) ? near_digits[rng() % sizeof(near_digits)] : (char)rng();
+            hex[rng() % hex.size()] = c;
+        }
+        if (round % 8 == 7 && !hex.empty()) {
+            hex.pop_back();
+        }
+        if (!same_decode(backend, hex)) {
+            return false;
+        }
+    }
+
+    for (size_t len = 0; len <= 160; len += 2) {
+        std::string hex(len, '0');
+        for (size_t i = 0; i < len; i++) {
+            hex[i] = "0123456789abcdefABCDEF"[rng() % 22];
+        }
+        if (!same_decode(backend, hex)) {
+            return false;
+        }
+        for (size_t pos = 0; pos < len; pos++) {
+            std::string bad = hex;
+            bad[pos] = near_digits[(len + pos) % sizeof(near_digits)];
+            if (!same_decode(backend, bad)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    unsigned long rounds = 100000;
+    unsigned long seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--rounds=", 9)) {
+            rounds = strtoul(argv[i] + 9, nullptr, 10);
+        } else if (!strncmp(argv[i], "--seed=", 7)) {
+            seed = strtoul(argv[i] + 7, nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: hex.check [--rounds=N] [--seed=N]\n");
+            return 1;
+        }
+    }
+
+    HexBackend original = hex_backend();
+    int failed = 0;
+    for (HexBackend backend : {HEX_BACKEND_SSSE3, HEX_BACKEND_AVX2, HEX_BACKEND_SIMD128}) {
+        if (!hex_backend_supported(backend)) {
+            printf("%-8s not supported here, skipped\n", backend_names[backend]);
+            continue;
+        }
+        bool ok = check_backend(backend, rounds, seed);
+        printf("%-8s %s\n", backend_names[backend], ok ? "matches scalar" : "DIFFERS from scalar");
+        failed += !ok;
+    }
+    hex_set_backend(original);
+    return failed ? 1 : 0;
+}
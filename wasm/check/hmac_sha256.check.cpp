@@ -0,0 +1,186 @@
+// Known-answer check of HMAC-SHA256 and PBKDF2-HMAC-SHA256 on the portable
+// and every hardware SHA-256 backend the CPU supports: RFC 4231 test cases
+// 2 and 6 (a short key, and a key longer than a block) and the RFC 7914
+// PBKDF2 vectors.
+//
+// The MACs are also computed with hmac_sha256_Update fed in pieces, and a
+// second message under the same key checks that Final resets the context.
+// A batch of passwords, long enough to fill the multi-buffer lanes several
+// times over, is derived with pbkdf2_hmac_sha256_batch and compared against
+// pbkdf2_hmac_sha256 one password at a time and against PBKDF2 written out
+// from its definition on top of hmac_sha256.
+//
+//   rogo check
+//   build/hmac_sha256.check
+//
+// The same file builds with emcc and runs under node.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "../hmac_sha256.hpp"
+#include "../sha256_multi.hpp"
+
+using namespace Hello;
+
+static const char* backend_names[] = {"portable", "sha-ni", "armv8"};
+
+static std::string hex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (size_t i = 0; i < len; i++) {
+        out += digits[data[i] >> 4];
+        out += digits[data[i] & 15];
+    }
+    return out;
+}
+
+static bool expect(SHA256_BACKEND backend, const char* name, const char* how, const uint8_t* got, size_t len,
+                   const std::string& want) {
+    if (hex(got, len) == want) {
+        return true;
+    }
+    fprintf(stderr, "%s: %s via %s: %s, expected %s\n", backend_names[backend], name, how, hex(got, len).c_str(), want.c_str());
+    return false;
+}
+
+struct MacVector {
+    const char* name;
+    std::string key;
+    std::string message;
+    const char* mac;
+};
+
+struct Pbkdf2Vector {
+    const char* name;
+    const char* password;
+    const char* salt;
+    uint32_t iterations;
+    size_t keylen;
+    const char* key;
+};
+
+// PBKDF2 (RFC 8018 section 5.2) spelled out with one-shot MACs.
+static void reference_pbkdf2(const std::string& pass, const std::string& salt, uint32_t iterations, uint8_t* key, size_t keylen) {
+    const uint8_t* p = (const uint8_t*)pass.data();
+    for (uint32_t block = 1; keylen > 0; block++) {
+        std::string first = salt;
+        first += (char)(block >> 24);
+        first += (char)(block >> 16);
+        first += (char)(block >> 8);
+        first += (char)block;
+        uint8_t u[SHA256_DIGEST_LENGTH], t[SHA256_DIGEST_LENGTH];
+        hmac_sha256(p, pass.size(), (const uint8_t*)first.data(), first.size(), u);
+        memcpy(t, u, sizeof(t));
+        for (uint32_t i = 1; i < iterations; i++) {
+            hmac_sha256(p, pass.size(), u, sizeof(u), u);
+            for (int k = 0; k < SHA256_DIGEST_LENGTH; k++) {
+                t[k] ^= u[k];
+            }
+        }
+        size_t n = keylen < sizeof(t) ? keylen : sizeof(t);
+        memcpy(key, t, n);
+        key += n;
+        keylen -= n;
+    }
+}
+
+static bool check_backend(SHA256_BACKEND backend, const std::vector<MacVector>& macs, const std::vector<Pbkdf2Vector>& pbkdf2s) {
+    bool ok = true;
+    uint8_t mac[SHA256_DIGEST_LENGTH];
+    for (const MacVector& v : macs) {
+        const uint8_t* key = (const uint8_t*)v.key.data();
+        const uint8_t* message = (const uint8_t*)v.message.data();
+        hmac_sha256(key, v.key.size(), message, v.message.size(), mac);
+        ok &= expect(backend, v.name, "hmac_sha256", mac, sizeof(mac), v.mac);
+
+        HMAC_SHA256_CTX ctx;
+        hmac_sha256_Init(&ctx, key, v.key.size());
+        for (size_t piece : {1, 7, 64}) {
+            for (size_t offset = 0; offset < v.message.size(); offset += piece) {
+                size_t n = v.message.size() - offset < piece ? v.message.size() - offset : piece;
+                hmac_sha256_Update(&ctx, message + offset, n);
+            }
+            hmac_sha256_Final(&ctx, mac);
+            char how[48];
+            snprintf(how, sizeof(how), "hmac_sha256_Update in %zu-byte pieces", piece);
+            ok &= expect(backend, v.name, how, mac, sizeof(mac), v.mac);
+        }
+        hmac_sha256_Clear(&ctx);
+    }
+
+    for (const Pbkdf2Vector& v : pbkdf2s) {
+        std::vector<uint8_t> key(v.keylen);
+        pbkdf2_hmac_sha256((const uint8_t*)v.password, strlen(v.password), (const uint8_t*)v.salt, strlen(v.salt), v.iterations,
+                           key.data(), key.size());
+        ok &= expect(backend, v.name, "pbkdf2_hmac_sha256", key.data(), key.size(), v.key);
+    }
+
+    // Passwords of 0 to 99 bytes (past one block, so some keys are hashed
+    // first) and 40-byte keys: two jobs each, which fills the 64-job batch
+    // three times over with a partial run at the end.
+    const std::string salt = "batch salt";
+    const uint32_t iterations = 3;
+    const size_t keylen = 40;
+    std::vector<std::string> passwords;
+    for (size_t len = 0; len < 100; len++) {
+        std::string pass;
+        for (size_t i = 0; i < len; i++) {
+            pass += (char)('a' + (i * 7 + len) % 26);
+        }
+        passwords.push_back(pass);
+    }
+    std::vector<const uint8_t*> passes;
+    std::vector<size_t> passlens;
+    for (const std::string& pass : passwords) {
+        passes.push_back((const uint8_t*)pass.data());
+        passlens.push_back(pass.size());
+    }
+    std::vector<uint8_t> keys(passwords.size() * keylen);
+    pbkdf2_hmac_sha256_batch(passes.data(), passlens.data(), passes.size(), (const uint8_t*)salt.data(), salt.size(), iterations,
+                             keys.data(), keylen);
+    for (size_t i = 0; i < passwords.size(); i++) {
+        uint8_t want[keylen], single[keylen];
+        reference_pbkdf2(passwords[i], salt, iterations, want, keylen);
+        pbkdf2_hmac_sha256(passes[i], passlens[i], (const uint8_t*)salt.data(), salt.size(), iterations, single, keylen);
+        char name[48];
+        snprintf(name, sizeof(name), "%zu-byte password", passlens[i]);
+        ok &= expect(backend, name, "pbkdf2_hmac_sha256", single, keylen, hex(want, keylen));
+        ok &= expect(backend, name, "pbkdf2_hmac_sha256_batch", &keys[i * keylen], keylen, hex(want, keylen));
+    }
+    return ok;
+}
+
+int main() {
+    std::vector<MacVector> macs = {
+        {"RFC 4231 case 2", "Jefe", "what do ya want for nothing?",
+         "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"},
+        {"RFC 4231 case 6", std::string(131, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First",
+         "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"},
+    };
+    std::vector<Pbkdf2Vector> pbkdf2s = {
+        {"RFC 7914 passwd/salt", "passwd", "salt", 1, 64,
+         "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+         "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783"},
+        {"RFC 7914 Password/NaCl", "Password", "NaCl", 80000, 64,
+         "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"
+         "a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d"},
+    };
+
+    SHA256_BACKEND original = sha256_Backend();
+    int failed = 0;
+    for (SHA256_BACKEND backend : {SHA256_BACKEND_PORTABLE, SHA256_BACKEND_SHA_NI, SHA256_BACKEND_ARMV8}) {
+        if (!sha256_SetBackend(backend)) {
+            printf("%-9s not supported here, skipped\n", backend_names[backend]);
+            continue;
+        }
+        bool ok = check_backend(backend, macs, pbkdf2s);
+        printf("%-9s %s (%zu batch lanes)\n", backend_names[backend], ok ? "ok" : "FAILED", sha256_BatchLanes());
+        failed += !ok;
+    }
+    sha256_SetBackend(original);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+// Checks sha256_PowSearch against a linear scan with sha256_PowCheck, on
+// the portable and every hardware SHA-256 backend the CPU supports, with a
+// one-thread pool and a pool of several threads.
+//
+// Prefix lengths run from 0 to 130, so the nonce lands at every offset of
+// the final block and the padding spills into a second block for some.
+// Difficulties are chosen so a solution usually falls past the first
+// SHA256_POW_CHUNK nonces and sometimes not at all. Ranges near 2^64 check
+// the clamp below 2^64 - 1; bits 0 and bits above SHA256_POW_MAX_BITS check
+// the edges of the difficulty.
+//
+//   rogo check
+//   build/sha256_pow.check [--threads=N]
+//
+// The same file builds with emcc and runs under node.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <random>
+#include <vector>
+
+#include "../sha256_pow.hpp"
+#include "../thread_pool.hpp"
+
+using namespace Hello;
+
+static const char* backend_names[] = {"portable", "sha-ni", "armv8"};
+
+// The smallest nonce in [start, start + count), clamped below 2^64 - 1,
+// that solves prefix, found one nonce at a time.
+static bool linear_search(const uint8_t* prefix, size_t len, unsigned bits, uint64_t start, uint64_t count, uint64_t* nonce) {
+    uint64_t end = count > UINT64_MAX - start ? UINT64_MAX : start + count;
+    for (uint64_t n = start; n < end; n++) {
+        if (sha256_PowCheck(prefix, len, n, bits)) {
+            *nonce = n;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool check_search(SHA256_BACKEND backend, ThreadPool& pool, const std::vector<uint8_t>& prefix, unsigned bits, uint64_t start,
+                         uint64_t count) {
+    uint64_t want = 0;
+    bool want_found = linear_search(prefix.data(), prefix.size(), bits, start, count, &want);
+
+    Sha256PowResult result;
+    memset(&result, 0xa5, sizeof(result));
+    bool found = sha256_PowSearch(prefix.data(), prefix.size(), bits, start, count, &result, &pool);
+    bool ok = found == want_found && result.found == (uint32_t)want_found;
+    if (ok && found) {
+        uint8_t digest[SHA256_DIGEST_LENGTH];
+        sha256_PowCheck(prefix.data(), prefix.size(), want, bits, digest);
+        ok = result.nonce == want && !memcmp(result.digest, digest, sizeof(digest));
+    }
+    if (!ok) {
+        fprintf(stderr, "%s, %zu threads: %zu-byte prefix, bits %u, start %llu, count %llu: ", backend_names[backend], pool.size(),
+                prefix.size(), bits, (unsigned long long)start, (unsigned long long)count);
+        if (found) {
+            fprintf(stderr, "found %llu", (unsigned long long)result.nonce);
+        } else {
+            fprintf(stderr, "found none");
+        }
+        if (want_found) {
+            fprintf(stderr, ", expected %llu\n", (unsigned long long)want);
+        } else {
+            fprintf(stderr, ", expected none\n");
+        }
+    }
+    return ok;
+}
+
+static bool check_backend(SHA256_BACKEND backend, ThreadPool& pool) {
+    std::mt19937_64 rng(1);
+    bool ok = true;
+    for (size_t len = 0; len <= 130; len++) {
+        std::vector<uint8_t> prefix(len);
+        for (uint8_t& byte : prefix) {
+            byte = (uint8_t)rng();
+        }
+        // 2^bits nonces per solution on average, against 4096-nonce chunks
+        unsigned bits = 9 + len % 5;
+        uint64_t start = rng() >> (len % 64);
+        ok &= check_search(backend, pool, prefix, bits, start, 3 * SHA256_POW_CHUNK + 17);
+    }
+
+    std::vector<uint8_t> prefix = {'p', 'o', 'w'};
+    ok &= check_search(backend, pool, prefix, 0, 12345, 1);
+    ok &= check_search(backend, pool, prefix, 0, UINT64_MAX - 1, 1);
+    ok &= check_search(backend, pool, prefix, 1, UINT64_MAX - 1, 1);
+    ok &= check_search(backend, pool, prefix, 10, UINT64_MAX - 5000, UINT64_MAX);
+    ok &= check_search(backend, pool, prefix, 12, UINT64_MAX - 3 * SHA256_POW_CHUNK, 2 * SHA256_POW_CHUNK);
+    ok &= check_search(backend, pool, prefix, 30, UINT64_MAX - 2 * SHA256_POW_CHUNK - 3, UINT64_MAX);
+    ok &= check_search(backend, pool, prefix, 8, UINT64_MAX, 10);
+    ok &= check_search(backend, pool, prefix, 8, 0, 0);
+    ok &= check_search(backend, pool, prefix, SHA256_POW_MAX_BITS + 1, 0, 100);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    size_t threads = 4;
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--threads=", 10)) {
+            threads = strtoul(argv[i] + 10, nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: sha256_pow.check [--threads=N]\n");
+            return 1;
+        }
+    }
+
+    ThreadPool one(1);
+    ThreadPool many(threads);
+    SHA256_BACKEND original = sha256_Backend();
+    int failed = 0;
+    for (SHA256_BACKEND backend : {SHA256_BACKEND_PORTABLE, SHA256_BACKEND_SHA_NI, SHA256_BACKEND_ARMV8}) {
+        if (!sha256_SetBackend(backend)) {
+            printf("%-9s not supported here, skipped\n", backend_names[backend]);
+            continue;
+        }
+        bool ok = check_backend(backend, one) && check_backend(backend, many);
+        printf("%-9s %s (1 and %zu threads)\n", backend_names[backend], ok ? "ok" : "FAILED", many.size());
+        failed += !ok;
+    }
+    sha256_SetBackend(original);
+    return failed ? 1 : 0;
+}
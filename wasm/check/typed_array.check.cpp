@@ -0,0 +1,243 @@
+// Checks the typed array kernels on every backend the CPU supports (the
+// scalar loops included) against the standard library: std::reverse,
+// std::minmax_element, std::accumulate and std::partial_sum, and a plain
+// byte reversal for array_ByteSwap.
+//
+// Every element type is run at each length up to a few vector blocks and at
+// random longer lengths. u8/i8 and u16/i16 sums are also run at all-maximum
+// inputs just short of, at and just past the lengths where the vector
+// kernels flush their narrow accumulators, where a missed flush would wrap.
+// Float inputs are small integers, so sums and prefix sums are exact in any
+// order; min/max must be NaN whenever an element is NaN, and -0.0 and 0.0
+// compare equal.
+//
+//   rogo check
+//   build/typed_array.check [--rounds=N] [--seed=N]
+//
+// The same file builds with emcc; with -msimd128 it checks the SIMD128
+// kernels under node.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "../typed_array.hpp"
+
+using namespace Hello;
+
+static const char* backend_names[] = {"scalar", "avx2", "simd128"};
+
+template <typename T> struct TypeName;
+template <> struct TypeName<uint8_t> { static constexpr const char* name = "u8"; };
+template <> struct TypeName<uint16_t> { static constexpr const char* name = "u16"; };
+template <> struct TypeName<uint32_t> { static constexpr const char* name = "u32"; };
+template <> struct TypeName<uint64_t> { static constexpr const char* name = "u64"; };
+template <> struct TypeName<int8_t> { static constexpr const char* name = "i8"; };
+template <> struct TypeName<int16_t> { static constexpr const char* name = "i16"; };
+template <> struct TypeName<int32_t> { static constexpr const char* name = "i32"; };
+template <> struct TypeName<int64_t> { static constexpr const char* name = "i64"; };
+template <> struct TypeName<float> { static constexpr const char* name = "f32"; };
+template <> struct TypeName<double> { static constexpr const char* name = "f64"; };
+
+template <typename T> static bool same(T a, T b) {
+    if constexpr (std::is_floating_point<T>::value) {
+        return a == b || (a != a && b != b);
+    } else {
+        return a == b;
+    }
+}
+
+// Compares element bits, so -0.0 and 0.0 differ here but NaNs with the same
+// payload match.
+template <typename T> static bool same_bits(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && (a.empty() || !memcmp(a.data(), b.data(), a.size() * sizeof(T)));
+}
+
+template <typename T> static T random_value(std::mt19937_64& rng) {
+    if constexpr (std::is_floating_point<T>::value) {
+        switch (rng() % 16) {
+        case 0:
+            return (T)-0.0;
+        case 1:
+            return (T)0.0;
+        default:
+            return (T)((int)(rng() % 2001) - 1000);
+        }
+    } else {
+        return (T)rng();
+    }
+}
+
+template <typename T> static bool fail(TypedArrayBackend backend, const char* what, size_t n) {
+    fprintf(stderr, "%s: %s %s of %zu elements differs\n", backend_names[backend], TypeName<T>::name, what, n);
+    return false;
+}
+
+template <typename T> static bool check_array(TypedArrayBackend backend, const std::vector<T>& data) {
+    typedef typename ArraySum<T>::type S;
+    const size_t n = data.size();
+
+    std::vector<T> got = data, want = data;
+    array_Reverse(got.data(), n);
+    std::reverse(want.begin(), want.end());
+    if (!same_bits(got, want)) {
+        return fail<T>(backend, "reverse", n);
+    }
+
+    got = data;
+    array_ByteSwap(got.data(), n);
+    want = data;
+    for (T& x : want) {
+        std::reverse((uint8_t*)&x, (uint8_t*)&x + sizeof(T));
+    }
+    if (!same_bits(got, want)) {
+        return fail<T>(backend, "byte swap", n);
+    }
+
+    T min = 0, max = 0;
+    bool any = array_MinMax(data.data(), n, &min, &max);
+    if (any != (n > 0)) {
+        return fail<T>(backend, "min/max", n);
+    }
+    if (n > 0) {
+        auto [lo, hi] = std::minmax_element(data.begin(), data.end());
+        T want_min = *lo, want_max = *hi;
+        if constexpr (std::is_floating_point<T>::value) {
+            if (std::any_of(data.begin(), data.end(), [](T x) { return x != x; })) {
+                want_min = want_max = std::numeric_limits<T>::quiet_NaN();
+            }
+        }
+        if (!same(min, want_min) || !same(max, want_max)) {
+            return fail<T>(backend, "min/max", n);
+        }
+    }
+
+    S sum = array_Sum(data.data(), n);
+    S want_sum;
+    if constexpr (std::is_floating_point<T>::value) {
+        want_sum = std::accumulate(data.begin(), data.end(), 0.0);
+    } else {
+        // Exact mod 2^64, without signed overflow.
+        want_sum = (S)std::accumulate(data.begin(), data.end(), (uint64_t)0, [](uint64_t a, T x) { return a + (uint64_t)(S)x; });
+    }
+    if (!same(sum, want_sum)) {
+        return fail<T>(backend, "sum", n);
+    }
+
+    got = data;
+    array_PrefixSum(got.data(), n);
+    want = data;
+    if constexpr (std::is_floating_point<T>::value) {
+        std::partial_sum(want.begin(), want.end(), want.begin());
+        for (size_t i = 0; i < n; i++) {
+            if (!same(got[i], want[i])) {
+                return fail<T>(backend, "prefix sum", n);
+            }
+        }
+    } else {
+        typedef typename std::make_unsigned<T>::type U;
+        std::partial_sum(want.begin(), want.end(), want.begin(), [](T a, T b) { return (T)(U)((U)a + (U)b); });
+        if (!same_bits(got, want)) {
+            return fail<T>(backend, "prefix sum", n);
+        }
+    }
+    return true;
+}
+
+template <typename T> static bool check_type(TypedArrayBackend backend, unsigned long rounds, std::mt19937_64& rng) {
+    std::vector<T> data;
+    for (size_t n = 0; n <= 160; n++) {
+        data.resize(n);
+        for (T& x : data) {
+            x = random_value<T>(rng);
+        }
+        if (!check_array(backend, data)) {
+            return false;
+        }
+    }
+    for (unsigned long round = 0; round < rounds; round++) {
+        data.resize(rng() % (round % 16 == 0 ? 100000 : 2000));
+        for (T& x : data) {
+            x = random_value<T>(rng);
+        }
+        if constexpr (std::is_floating_point<T>::value) {
+            // A NaN in one place, or every element -0.0
+            if (round % 4 == 1 && !data.empty()) {
+                data[rng() % data.size()] = std::numeric_limits<T>::quiet_NaN();
+            } else if (round % 4 == 2) {
+                std::fill(data.begin(), data.end(), (T)-0.0);
+            }
+        }
+        if (!check_array(backend, data)) {
+            return false;
+        }
+    }
+
+    if constexpr (sizeof(T) <= 2 && !std::is_floating_point<T>::value) {
+        // Narrow accumulators: AVX2 flushes u16 sums every 16 << 15
+        // elements; SIMD128 flushes u8 every 16 << 20 and u16 every 8 << 15.
+        const size_t flush = sizeof(T) == 1 ? (size_t)16 << 20 : (size_t)16 << 15;
+        const size_t flushes[] = {flush / 2, flush};
+        for (size_t at : flushes) {
+            for (size_t n : {at - 1, at, at + 1, at + 33, 2 * at + 7}) {
+                data.assign(n, std::numeric_limits<T>::max());
+                typedef typename ArraySum<T>::type S;
+                if (array_Sum(data.data(), n) != (S)n * std::numeric_limits<T>::max()) {
+                    return fail<T>(backend, "sum of maximums", n);
+                }
+                if (std::is_signed<T>::value) {
+                    data.assign(n, std::numeric_limits<T>::min());
+                    if (array_Sum(data.data(), n) != (S)n * std::numeric_limits<T>::min()) {
+                        return fail<T>(backend, "sum of minimums", n);
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool check_backend(TypedArrayBackend backend, unsigned long rounds, unsigned long seed) {
+    std::mt19937_64 rng(seed);
+    return check_type<uint8_t>(backend, rounds, rng) && check_type<uint16_t>(backend, rounds, rng) &&
+           check_type<uint32_t>(backend, rounds, rng) && check_type<uint64_t>(backend, rounds, rng) &&
+           check_type<int8_t>(backend, rounds, rng) && check_type<int16_t>(backend, rounds, rng) &&
+           check_type<int32_t>(backend, rounds, rng) && check_type<int64_t>(backend, rounds, rng) &&
+           check_type<float>(backend, rounds, rng) && check_type<double>(backend, rounds, rng);
+}
+
+int main(int argc, char** argv) {
+    unsigned long rounds = 200;
+    unsigned long seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--rounds=", 9)) {
+            rounds = strtoul(argv[i] + 9, nullptr, 10);
+        } else if (!strncmp(argv[i], "--seed=", 7)) {
+            seed = strtoul(argv[i] + 7, nullptr, 10);
+        } else {
+            fprintf(stderr, "usage: typed_array.check [--rounds=N] [--seed=N]\n");
+            return 1;
+        }
+    }
+
+    TypedArrayBackend original = typed_array_backend();
+    int failed = 0;
+    for (TypedArrayBackend backend : {TYPED_ARRAY_BACKEND_SCALAR, TYPED_ARRAY_BACKEND_AVX2, TYPED_ARRAY_BACKEND_SIMD128}) {
+        if (!typed_array_set_backend(backend)) {
+            printf("%-8s not supported here, skipped\n", backend_names[backend]);
+            continue;
+        }
+        bool ok = check_backend(backend, rounds, seed);
+        printf("%-8s %s\n", backend_names[backend], ok ? "ok" : "FAILED");
+        failed += !ok;
+    }
+    typed_array_set_backend(original);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+#include "cpu.hpp"
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define HELLO_CPU_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define HELLO_CPU_ARM64 1
+#if defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#endif
+#endif
+
+namespace Hello
+{
+
+#ifdef HELLO_CPU_X86
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) {
+        regs[i] = (uint32_t)r[i];
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Reads XCR0 to check that the OS saves the YMM registers on context switch.
+static uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0, edx = 0;
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+#endif
+
+static CpuFeatures detect_cpu_features() {
+    CpuFeatures features = {};
+#ifdef HELLO_CPU_X86
+    uint32_t regs[4] = {0};
+    cpuid(0, 0, regs);
+    uint32_t max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    features.sse2 = (regs[3] >> 26) & 1;
+    bool osxsave = (regs[2] >> 27) & 1;
+    bool avx = (regs[2] >> 28) & 1;
+    bool ymm_enabled = osxsave && (xgetbv0() & 0x6) == 0x6;
+    bool sse41 = (regs[2] >> 19) & 1;
+    features.ssse3 = (regs[2] >> 9) & 1;
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        features.avx2 = avx && ymm_enabled && ((regs[1] >> 5) & 1);
+        features.sha_ni = features.ssse3 && sse41 && ((regs[1] >> 29) & 1);
+    }
+#endif
+#ifdef HELLO_CPU_ARM64
+#if defined(__APPLE__) || defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO)
+    features.arm_sha2 = true;
+#elif defined(__linux__)
+    features.arm_sha2 = (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#endif
+#endif
+    return features;
+}
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect_cpu_features();
+    return features;
+}
+
+} // namespace Hello
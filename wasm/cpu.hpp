@@ -0,0 +1,21 @@
+#ifndef HELLO_CPU_HPP
+#define HELLO_CPU_HPP
+
+namespace Hello
+{
+
+// Instruction set extensions of the host CPU that the kernels dispatch on.
+struct CpuFeatures {
+    bool sse2;
+    bool ssse3;
+    bool avx2;
+    bool sha_ni;    // x86 SHA extensions, together with the SSSE3/SSE4.1 they need
+    bool arm_sha2;  // ARMv8 SHA256H/SHA256H2/SHA256SU0/SHA256SU1
+};
+
+// Returns the features of the running CPU. Detection runs once, on first use.
+const CpuFeatures& cpu_features();
+
+} // namespace Hello
+
+#endif
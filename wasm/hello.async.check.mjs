@@ -0,0 +1,59 @@
+// Checks that hello.async.js, with its coalesced batches, answers exactly as
+// the module does when called directly on the main thread.
+//
+//   node hello.async.check.mjs <directory holding hello.async.js and hello.loader.js>
+
+import path from 'node:path';
+import { pathToFileURL } from 'node:url';
+
+const dir = path.resolve(process.argv[2] ?? '.');
+const { default: instantiate_hello } = await import(pathToFileURL(path.join(dir, 'hello.loader.js')));
+const { createHelloAsync } = await import(pathToFileURL(path.join(dir, 'hello.async.js')));
+
+const inputs = [];
+for(let len = 0; len < 300; len += 7) {
+    inputs.push(Uint8Array.from({ length: len }, (_, i) => (i * 131 + len) & 0xff));
+}
+inputs.push(new Uint8Array(1 << 20).fill(7));
+
+const mod = await instantiate_hello();
+const hello = await createHelloAsync({ workers: 2 });
+const show = (v) => JSON.stringify(v, (k, x) => (x instanceof Uint8Array ? Array.from(x) : x));
+
+const expected = show([
+    inputs.map((d) => mod.sha256(d)),
+    inputs.map((d) => mod.dataToHex(d)),
+    inputs.map((d) => mod.hexToData(mod.dataToHex(d))),
+    mod.hexToData('0g'),
+    mod.hmacSha256('key', inputs[5]),
+]);
+// Inputs are copied because the facade transfers (detaches) them.
+const actual = show(await Promise.all([
+    Promise.all(inputs.map((d) => hello.sha256(d.slice()))),
+    Promise.all(inputs.map((d) => hello.dataToHex(d.slice()))),
+    Promise.all(inputs.map((d) => hello.hexToData(mod.dataToHex(d)))),
+    hello.hexToData('0g'),
+    hello.hmacSha256('key', inputs[5].slice()),
+]));
+if(actual !== expected) {
+    hello.terminate();
+    console.error('hello.async: worker results differ from direct calls');
+    process.exit(1);
+}
+
+// A whole-buffer input is transferred by the first call; reusing it must
+// fail rather than hash the detached (empty) view as no bytes.
+const reused = inputs[5].slice();
+await hello.sha256(reused);
+const second = await hello.sha256(reused).then(() => null, (e) => e);
+const empty = await hello.sha256(new Uint8Array(0));
+hello.terminate();
+if(!(second instanceof TypeError)) {
+    console.error('hello.async: a detached input buffer was not rejected');
+    process.exit(1);
+}
+if(show(empty) !== show(mod.sha256(new Uint8Array(0)))) {
+    console.error('hello.async: an empty input no longer hashes as empty');
+    process.exit(1);
+}
+console.log('hello.async: worker results match direct calls');
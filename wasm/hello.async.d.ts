@@ -0,0 +1,14 @@
+// Types for hello.async.js.
+
+export interface HelloAsync {
+    sha256(data: Uint8Array | string): Promise<Uint8Array>;
+    sha256d(data: Uint8Array | string): Promise<Uint8Array>;
+    sha256Tree(data: Uint8Array | string, leafSize?: number): Promise<{ root: Uint8Array; leaves: Uint8Array }>;
+    hmacSha256(key: Uint8Array | string, message: Uint8Array | string): Promise<Uint8Array>;
+    pbkdf2HmacSha256(password: Uint8Array | string, salt: Uint8Array | string, iterations: number, keyLength?: number): Promise<Uint8Array>;
+    dataToHex(data: Uint8Array | string): Promise<string>;
+    hexToData(hex: string): Promise<Uint8Array | null>;
+    terminate(): void;
+}
+
+export function createHelloAsync(options?: { workers?: number }): Promise<HelloAsync>;
@@ -0,0 +1,279 @@
+// Promise-based facade over hello.worker.js: the hello module runs in one or
+// more Workers (node:worker_threads under Node), so large inputs never block
+// the calling thread.
+//
+//   const hello = await createHelloAsync({ workers: 2 });
+//   const digest = await hello.sha256(bytes);
+//   hello.terminate();
+//
+// A byte input that spans its whole ArrayBuffer is transferred, not copied:
+// once the request is sent at the end of the tick the caller's buffer is
+// detached, so pass data.slice() to keep using it; passing the detached
+// array again rejects with a TypeError. A view into part of a larger buffer
+// (e.g. a pooled Node Buffer) has just its bytes copied, and the copy is
+// transferred. Strings are encoded to UTF-8 here and the encoded bytes are
+// transferred.
+//
+// Requests made in the same tick are sent together in one message. sha256,
+// dataToHex and hexToData requests of up to BATCH_LIMIT bytes each are
+// coalesced into a single wasm call on one worker; larger requests are
+// spread over the least busy workers.
+
+const BATCH_LIMIT = 64 * 1024;
+const COALESCED = new Set(['sha256', 'dataToHex', 'hexToData']);
+
+const encoder = new TextEncoder();
+
+function detached(buffer) {
+    if(buffer.detached !== undefined) {
+        return buffer.detached;
+    }
+    // Runtimes without ArrayBuffer.prototype.detached: only a detached
+    // buffer refuses a new view.
+    try {
+        new Uint8Array(buffer, 0, 0);
+        return false;
+    } catch {
+        return true;
+    }
+}
+
+function bytes(input) {
+    if(typeof input === 'string') {
+        return encoder.encode(input);
+    }
+    if(input.length === 0) {
+        // A view of a buffer an earlier request transferred reads as empty;
+        // hashing it as no bytes would silently give the wrong answer.
+        if(detached(input.buffer)) {
+            throw new TypeError('hello: input buffer was transferred by an earlier request; pass data.slice() to keep it');
+        }
+        return new Uint8Array(0);
+    }
+    if(input.byteOffset !== 0 || input.byteLength !== input.buffer.byteLength) {
+        return new Uint8Array(input);
+    }
+    return input;
+}
+
+async function spawn() {
+    const url = new URL('./hello.worker.js', import.meta.url);
+    if(typeof Worker !== 'undefined') {
+        const worker = new Worker(url, { type: 'module' });
+        return {
+            post: (message, transfer) => worker.postMessage(message, transfer),
+            listen: (fn) => worker.addEventListener('message', (e) => fn(e.data)),
+            failed: (fn) => worker.addEventListener('error', (e) => fn(new Error(e.message))),
+            idle: () => {},
+            terminate: () => worker.terminate(),
+        };
+    }
+    const { Worker: NodeWorker } = await import('node:worker_threads');
+    // Unreferenced while idle, so an unused pool does not keep Node alive.
+    // Adding a message listener refs the worker again, hence the unref there.
+    const worker = new NodeWorker(url);
+    return {
+        post: (message, transfer) => {
+            worker.ref();
+            worker.postMessage(message, transfer);
+        },
+        listen: (fn) => {
+            worker.on('message', fn);
+            worker.unref();
+        },
+        failed: (fn) => worker.on('error', fn),
+        idle: () => worker.unref(),
+        terminate: () => worker.terminate(),
+    };
+}
+
+export async function createHelloAsync({ workers = 1 } = {}) {
+    const pool = [];
+    const pending = new Map();
+    let nextId = 1;
+    let queue = [];
+    // Set once a replacement worker could not be started, or died before
+    // answering; later calls fail with it instead of waiting for a worker
+    // that will never come.
+    let broken = null;
+    let terminated = false;
+
+    function settle(id, error, result) {
+        const request = pending.get(id);
+        if(request === undefined) {
+            // already failed, e.g. by terminate()
+            return;
+        }
+        pending.delete(id);
+        if(error !== undefined) {
+            request.reject(error);
+        } else {
+            request.resolve(result);
+        }
+    }
+
+    async function addWorker(replacement = false) {
+        const worker = await spawn();
+        if(terminated) {
+            worker.terminate();
+            return;
+        }
+        worker.busy = 0;
+        // Requests sent to this worker and not answered yet
+        worker.ids = new Set();
+        worker.answered = false;
+        worker.listen((replies) => {
+            worker.answered = true;
+            if(--worker.busy === 0) {
+                worker.idle();
+            }
+            for(const { id, result, error } of replies) {
+                worker.ids.delete(id);
+                settle(id, error === undefined ? undefined : new Error(error), result);
+            }
+        });
+        // A worker that dies fails only its own outstanding requests. It
+        // leaves the pool and a fresh one takes its place; requests made in
+        // the meantime wait in the queue. A replacement that dies before
+        // answering anything would most likely die the same way again, so
+        // it is not replaced and the pool is marked broken instead.
+        worker.failed((error) => {
+            const index = pool.indexOf(worker);
+            if(index < 0) {
+                return;
+            }
+            pool.splice(index, 1);
+            worker.terminate();
+            for(const id of worker.ids) {
+                settle(id, error);
+            }
+            worker.ids.clear();
+            if(terminated) {
+                return;
+            }
+            if(replacement && !worker.answered) {
+                broken = error;
+                if(!pool.length) {
+                    failQueued(error);
+                }
+                return;
+            }
+            addWorker(true).then(flush, (e) => {
+                broken = e;
+                if(!pool.length) {
+                    failQueued(e);
+                }
+            });
+        });
+        pool.push(worker);
+    }
+
+    for(let i = 0; i < workers; i++) {
+        await addWorker();
+    }
+
+    function failQueued(error) {
+        const requests = queue;
+        queue = [];
+        for(const { id } of requests) {
+            settle(id, error);
+        }
+    }
+
+    function idlest() {
+        return pool.reduce((a, b) => (b.busy < a.busy ? b : a));
+    }
+
+    function send(worker, requests) {
+        const transfer = new Set();
+        for(const { args } of requests) {
+            for(const arg of args) {
+                if(arg instanceof Uint8Array && arg.buffer instanceof ArrayBuffer) {
+                    transfer.add(arg.buffer);
+                }
+            }
+        }
+        try {
+            worker.post(requests, [...transfer]);
+            worker.busy++;
+            for(const { id } of requests) {
+                worker.ids.add(id);
+            }
+        } catch(e) {
+            // e.g. a buffer already detached by an earlier request
+            for(const { id } of requests) {
+                settle(id, e);
+            }
+        }
+    }
+
+    // Sends everything queued during this tick: small coalescable requests
+    // to one worker in one message, each large one to the idlest worker.
+    function flush() {
+        if(!pool.length) {
+            // a replacement worker is starting and flushes when it is up
+            return;
+        }
+        const requests = queue;
+        queue = [];
+        const small = [];
+        for(const request of requests) {
+            const size = request.args[0]?.length ?? 0;
+            if(COALESCED.has(request.op) && size <= BATCH_LIMIT) {
+                small.push(request);
+            } else {
+                send(idlest(), [request]);
+            }
+        }
+        if(small.length) {
+            send(idlest(), small);
+        }
+    }
+
+    function call(op, ...args) {
+        if(broken !== null && !pool.length) {
+            return Promise.reject(broken);
+        }
+        return new Promise((resolve, reject) => {
+            const id = nextId++;
+            pending.set(id, { resolve, reject });
+            if(!queue.length) {
+                queueMicrotask(flush);
+            }
+            queue.push({ id, op, args });
+        });
+    }
+
+    // The methods are async so that a bad argument (e.g. a detached buffer)
+    // rejects the returned promise instead of throwing; call() still runs
+    // synchronously, so requests made in one tick are still sent together.
+    return {
+        // SHA256 digest (32 bytes) of the bytes or UTF-8 string.
+        sha256: async (data) => call('sha256', bytes(data)),
+        // SHA256(SHA256(data)).
+        sha256d: async (data) => call('sha256d', bytes(data)),
+        // { root, leaves } as returned by Module.sha256Tree.
+        sha256Tree: async (data, leafSize = 1024 * 1024) => {
+            if(!Number.isSafeInteger(leafSize) || leafSize <= 0 || leafSize > 0xffffffff) {
+                throw new RangeError('leafSize must be a positive integer');
+            }
+            return call('sha256Tree', bytes(data), leafSize);
+        },
+        hmacSha256: async (key, message) => call('hmacSha256', bytes(message), bytes(key)),
+        pbkdf2HmacSha256: async (password, salt, iterations, keyLength = 32) =>
+            call('pbkdf2HmacSha256', bytes(password), bytes(salt), iterations, keyLength),
+        dataToHex: async (data) => call('dataToHex', bytes(data)),
+        // Decoded bytes, or null if hex is not valid hexadecimal.
+        hexToData: async (hex) => call('hexToData', hex),
+        terminate() {
+            terminated = true;
+            for(const worker of pool) {
+                worker.terminate();
+            }
+            for(const { reject } of pending.values()) {
+                reject(new Error('hello worker terminated'));
+            }
+            pending.clear();
+        },
+    };
+}
@@ -2,13 +2,87 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
-#include <algorithm>
+#else
+// Native builds (bench/kernels.bench.cpp) link the same exports directly.
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#include "arena.hpp"
+#include "hmac_sha256.hpp"
 #include "sha256.hpp"
+#include "sha256_cdc.hpp"
+#include "sha256_fixed.hpp"
+#include "sha256_midstate.hpp"
+#include "sha256_multi.hpp"
+#include "sha256_pow.hpp"
+#include "sha256_tree.hpp"
 #include "hex.hpp"
+#include "sverdle.hpp"
+#include "sverdle_solver.hpp"
+#include "typed_array.hpp"
+#include "memzero.hpp"
+#include "secure_arena.hpp"
+#include "stats.hpp"
+
+// Per-module scratch space for marshalling. Buffers handed to JS by
+// scratch_alloc, and the results of data_to_hex, hex_to_data and
+// return_string, stay valid until the next scratch_reset; they are null
+// (hex_to_data returns false) when the arena cannot grow. Inputs may be
+// key material, so every reset wipes what the round used.
+static Hello::Arena scratch(64 * 1024, true);
+
+// Hash and HMAC contexts, and the buffers JS gets from secure_alloc: reused
+// slots that are wiped when released.
+static Hello::SecurePool secure(true);
+
+// Midstates of recently used prefixes, for sha256_prefixed.
+static Hello::Sha256PrefixCache prefix_cache;
+
+// Calls fn with p as a pointer to the element type of a
+// Hello::TypedArrayType. Returns false for an unknown type.
+template <typename Fn>
+static bool typed_array_visit(void* p, int type, Fn fn) {
+    switch(type) {
+    case Hello::TYPED_ARRAY_U8: fn((uint8_t*)p); return true;
+    case Hello::TYPED_ARRAY_U16: fn((uint16_t*)p); return true;
+    case Hello::TYPED_ARRAY_U32: fn((uint32_t*)p); return true;
+    case Hello::TYPED_ARRAY_U64: fn((uint64_t*)p); return true;
+    case Hello::TYPED_ARRAY_I8: fn((int8_t*)p); return true;
+    case Hello::TYPED_ARRAY_I16: fn((int16_t*)p); return true;
+    case Hello::TYPED_ARRAY_I32: fn((int32_t*)p); return true;
+    case Hello::TYPED_ARRAY_I64: fn((int64_t*)p); return true;
+    case Hello::TYPED_ARRAY_F32: fn((float*)p); return true;
+    case Hello::TYPED_ARRAY_F64: fn((double*)p); return true;
+    default: return false;
+    }
+}
 
 extern "C" {
 
+EMSCRIPTEN_KEEPALIVE
+void* scratch_alloc(size_t size) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SCRATCH_ALLOC, size);
+    return scratch.alloc(size);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void scratch_reset() {
+    scratch.reset();
+}
+
+// Zeroed buffer that outlives scratch_reset, e.g. a staging buffer for key
+// material; secure_free wipes it. size must match the secure_alloc call.
+EMSCRIPTEN_KEEPALIVE
+void* secure_alloc(size_t size) {
+    return secure.alloc(size);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void secure_free(void* p, size_t size) {
+    secure.release(p, size);
+}
+
 EMSCRIPTEN_KEEPALIVE
 int int_sqrt(int x) {
     return sqrt(x);
@@ -44,45 +118,409 @@ void print_u8_array(uint8_t* bytes, size_t len) {
 EMSCRIPTEN_KEEPALIVE
 char* return_string() {
     auto s = "Hello, WebAssembly!";
-    char* c = (char*)malloc(strlen(s)+1);
+    char* c = (char*)scratch.alloc(strlen(s)+1);
+    if(!c) {
+        return nullptr;
+    }
     strcpy(c, s);
     return c;
 }
 
 EMSCRIPTEN_KEEPALIVE
 void reverse(int32_t* p, size_t len) {
-    for(int i = 0; i < len / 2; i++) {
-        std::swap(p[i], p[len - i - 1]);
-    }
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_REVERSE, len * 4);
+    Hello::array_Reverse(p, len);
+}
+
+// Typed array kernels (see typed_array.hpp). p points at n elements of a
+// Hello::TypedArrayType and is worked on in place, so a view of the wasm
+// heap needs no copies. Each returns false for an unknown type.
+EMSCRIPTEN_KEEPALIVE
+bool array_reverse(void* p, size_t n, int type) {
+    return typed_array_visit(p, type, [&](auto* a) {
+        HELLO_STATS_SCOPE(Hello::HELLO_STAT_TYPED_ARRAY, n * sizeof(*a));
+        Hello::array_Reverse(a, n);
+    });
+}
+
+EMSCRIPTEN_KEEPALIVE
+bool array_bswap(void* p, size_t n, int type) {
+    return typed_array_visit(p, type, [&](auto* a) {
+        HELLO_STATS_SCOPE(Hello::HELLO_STAT_TYPED_ARRAY, n * sizeof(*a));
+        Hello::array_ByteSwap(a, n);
+    });
+}
+
+// out receives the smallest and then the largest element. Also false, with
+// out untouched, when n is 0.
+EMSCRIPTEN_KEEPALIVE
+bool array_minmax(const void* p, size_t n, int type, void* out) {
+    bool found = false;
+    bool known = typed_array_visit((void*)p, type, [&](auto* a) {
+        HELLO_STATS_SCOPE(Hello::HELLO_STAT_TYPED_ARRAY, n * sizeof(*a));
+        auto* minmax = (decltype(a))out;
+        found = Hello::array_MinMax(a, n, &minmax[0], &minmax[1]);
+    });
+    return known && found;
+}
+
+// out receives 8 bytes: a uint64_t, int64_t or double as array_Sum returns
+// for the type.
+EMSCRIPTEN_KEEPALIVE
+bool array_sum(const void* p, size_t n, int type, void* out) {
+    return typed_array_visit((void*)p, type, [&](auto* a) {
+        HELLO_STATS_SCOPE(Hello::HELLO_STAT_TYPED_ARRAY, n * sizeof(*a));
+        auto sum = Hello::array_Sum(a, n);
+        static_assert(sizeof(sum) == 8, "sums are 8 bytes");
+        memcpy(out, &sum, sizeof(sum));
+    });
+}
+
+EMSCRIPTEN_KEEPALIVE
+bool array_prefix_sum(void* p, size_t n, int type) {
+    return typed_array_visit(p, type, [&](auto* a) {
+        HELLO_STATS_SCOPE(Hello::HELLO_STAT_TYPED_ARRAY, n * sizeof(*a));
+        Hello::array_PrefixSum(a, n);
+    });
 }
 
 EMSCRIPTEN_KEEPALIVE
 void sha256(const uint8_t* data, size_t len, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256, len);
     Hello::sha256_Raw(data, len, digest);
 }
 
+EMSCRIPTEN_KEEPALIVE
+void sha256d(const uint8_t* data, size_t len, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256D, len);
+    Hello::sha256d(data, len, digest);
+}
+
+// Incremental hashing: a context lives in the wasm heap between calls so that
+// JS can feed arbitrarily large inputs through a small staging buffer.
+EMSCRIPTEN_KEEPALIVE
+Hello::SHA256_CTX* sha256_create() {
+    auto ctx = (Hello::SHA256_CTX*)secure.alloc(sizeof(Hello::SHA256_CTX));
+    if(ctx) {
+        Hello::sha256_Init(ctx);
+    }
+    return ctx;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void sha256_update(Hello::SHA256_CTX* ctx, const uint8_t* data, size_t len) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256_UPDATE, len);
+    Hello::sha256_Update(ctx, data, len);
+}
+
+// Writes the digest and re-initializes ctx so it can hash another message.
+EMSCRIPTEN_KEEPALIVE
+void sha256_final(Hello::SHA256_CTX* ctx, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    Hello::sha256_Final(ctx, digest);
+    Hello::sha256_Init(ctx);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void sha256_destroy(Hello::SHA256_CTX* ctx) {
+    secure.release(ctx, sizeof(Hello::SHA256_CTX));
+}
+
+// Serialized midstate (SHA256_MIDSTATE_LENGTH bytes) after absorbing prefix.
+EMSCRIPTEN_KEEPALIVE
+void sha256_midstate(const uint8_t* prefix, size_t len, uint8_t* midstate) {
+    Hello::SHA256_CTX ctx;
+    Hello::sha256_Init(&ctx);
+    Hello::sha256_Update(&ctx, prefix, len);
+    Hello::sha256_SaveMidstate(&ctx, midstate);
+    Hello::memzero(&ctx, sizeof(ctx));
+}
+
+// Returns false if midstate is not a serialized midstate this build reads.
+EMSCRIPTEN_KEEPALIVE
+bool sha256_resume(const uint8_t* midstate, const uint8_t* suffix, size_t len, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256_RESUME, len);
+    Hello::SHA256_CTX ctx;
+    if(!Hello::sha256_LoadMidstate(&ctx, midstate)) {
+        return false;
+    }
+    Hello::sha256_Resume(&ctx, suffix, len, digest);
+    Hello::memzero(&ctx, sizeof(ctx));
+    return true;
+}
+
+EMSCRIPTEN_KEEPALIVE
+bool sha256_resume_batch(const uint8_t* midstate, const uint8_t* const* suffixes, const size_t* lens, size_t n, uint8_t* digests) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256_RESUME, Hello::stats_total(lens, n));
+    Hello::SHA256_CTX ctx;
+    if(!Hello::sha256_LoadMidstate(&ctx, midstate)) {
+        return false;
+    }
+    Hello::sha256_ResumeBatch(&ctx, suffixes, lens, n, (uint8_t (*)[SHA256_DIGEST_LENGTH])digests);
+    Hello::memzero(&ctx, sizeof(ctx));
+    return true;
+}
+
+// SHA256(prefix || suffix), absorbing each distinct prefix only once while it
+// stays in the module's LRU prefix cache.
+EMSCRIPTEN_KEEPALIVE
+void sha256_prefixed(const uint8_t* prefix, size_t prefix_len, const uint8_t* suffix, size_t suffix_len,
+                     uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256_PREFIXED, prefix_len + suffix_len);
+    prefix_cache.hash(prefix, prefix_len, suffix, suffix_len, digest);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void sha256_batch(const uint8_t* const* msgs, const size_t* lens, size_t n, uint8_t* digests) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256_BATCH, Hello::stats_total(lens, n));
+    Hello::sha256_RawBatch(msgs, lens, n, (uint8_t (*)[SHA256_DIGEST_LENGTH])digests);
+}
+
+// Tree hash (see sha256_tree.hpp). Leaves are hashed on the shared thread
+// pool, which only has workers in a pthreads build. leaves may be null, or
+// room for sha256_TreeLeafCount(len, leaf_size) digests. Returns false if
+// leaf_size is 0.
+EMSCRIPTEN_KEEPALIVE
+bool sha256_tree(const uint8_t* data, size_t len, size_t leaf_size, uint8_t root[SHA256_DIGEST_LENGTH], uint8_t* leaves) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256_TREE, len);
+    return Hello::sha256_Tree(data, len, leaf_size, root, (uint8_t (*)[SHA256_DIGEST_LENGTH])leaves);
+}
+
+EMSCRIPTEN_KEEPALIVE
+bool sha256_tree_verify_range(const uint8_t* data, size_t len, size_t leaf_size, size_t offset, size_t range_len,
+                              const uint8_t* leaves, const uint8_t root[SHA256_DIGEST_LENGTH]) {
+    return Hello::sha256_TreeVerifyRange(data, len, leaf_size, offset, range_len, (const uint8_t (*)[SHA256_DIGEST_LENGTH])leaves, root);
+}
+
+// Proof-of-work nonce search (see sha256_pow.hpp) on the shared thread
+// pool, which only has workers in a pthreads build. range holds the first
+// nonce and the number of nonces to try, as 64-bit values in memory since
+// the exports take no 64-bit arguments.
+EMSCRIPTEN_KEEPALIVE
+bool sha256_pow_search(const uint8_t* prefix, size_t len, uint32_t bits, const uint64_t* range, Hello::Sha256PowResult* result) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_SHA256_POW_SEARCH, len);
+    return Hello::sha256_PowSearch(prefix, len, bits, range[0], range[1], result);
+}
+
+// Whether *nonce solves prefix at bits; digest receives the hash.
+EMSCRIPTEN_KEEPALIVE
+bool sha256_pow_check(const uint8_t* prefix, size_t len, const uint64_t* nonce, uint32_t bits, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    return Hello::sha256_PowCheck(prefix, len, *nonce, bits, digest);
+}
+
+// Content-defined chunking (see sha256_cdc.hpp). Chunks are cut on the
+// calling thread and hashed on the shared thread pool; without pthreads
+// both happen inline. Returns null if the sizes are invalid.
+EMSCRIPTEN_KEEPALIVE
+Hello::Sha256Chunker* chunker_create(size_t min_size, size_t avg_size, size_t max_size) {
+    Hello::CdcParams params;
+    if(!Hello::cdc_Params(min_size, avg_size, max_size, &params)) {
+        return nullptr;
+    }
+    return new Hello::Sha256Chunker(params);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void chunker_update(Hello::Sha256Chunker* chunker, const uint8_t* data, size_t len) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_CHUNKER_UPDATE, len);
+    chunker->update(data, len);
+}
+
+// Returns the manifest and stores its length in *count. The records stay
+// valid until the next chunker_finish or chunker_destroy; the chunker can
+// then take another input.
+EMSCRIPTEN_KEEPALIVE
+const Hello::ChunkRecord* chunker_finish(Hello::Sha256Chunker* chunker, size_t* count) {
+    const auto& manifest = chunker->finish();
+    *count = manifest.size();
+    return manifest.data();
+}
+
+EMSCRIPTEN_KEEPALIVE
+void chunker_destroy(Hello::Sha256Chunker* chunker) {
+    delete chunker;
+}
+
+EMSCRIPTEN_KEEPALIVE
+Hello::ChunkIndex* chunk_index_create() {
+    return new Hello::ChunkIndex();
+}
+
+// known receives one byte per record: 1 if its digest was indexed before.
+// Returns the number of records that were new.
+EMSCRIPTEN_KEEPALIVE
+size_t chunk_index_add(Hello::ChunkIndex* index, const Hello::ChunkRecord* records, size_t n, uint8_t* known) {
+    static_assert(sizeof(bool) == 1, "known is written as bool");
+    return index->add(records, n, (bool*)known);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void chunk_index_destroy(Hello::ChunkIndex* index) {
+    delete index;
+}
+
+// Sverdle engine (see sverdle.hpp). Words cross the boundary packed, so a
+// guess costs no marshalling and no allocation.
+EMSCRIPTEN_KEEPALIVE
+size_t sverdle_answer_count() {
+    return Hello::sverdle_AnswerCount();
+}
+
+// The packed answer for a game index, or -1 if there is no such answer.
+EMSCRIPTEN_KEEPALIVE
+int32_t sverdle_answer(size_t index) {
+    return (int32_t)Hello::sverdle_Answer(index);
+}
+
+EMSCRIPTEN_KEEPALIVE
+bool sverdle_allowed(uint32_t word) {
+    return Hello::sverdle_Allowed(word);
+}
+
+// Feedback byte for a guess against the answer of a game index, or -1 if
+// the guess is not in the dictionary or there is no such answer.
+EMSCRIPTEN_KEEPALIVE
+int sverdle_enter(uint32_t guess, size_t index) {
+    uint32_t answer = Hello::sverdle_Answer(index);
+    if(answer == SVERDLE_INVALID || !Hello::sverdle_Allowed(guess)) {
+        return -1;
+    }
+    return Hello::sverdle_Score(guess, answer);
+}
+
+// Built on first use: the solver's feedback matrix fills in as guesses are
+// scored (see sverdle_solver.hpp).
+static Hello::SverdleSolver& sverdle_solver() {
+    static Hello::SverdleSolver solver;
+    return solver;
+}
+
+// Best next guess for a game so far, given its n played guesses (packed)
+// and the feedback byte each got. Returns the packed guess, or -1 if a
+// played guess is not allowed or no answer fits the feedback; remaining
+// receives the number of answers still possible.
+EMSCRIPTEN_KEEPALIVE
+int32_t sverdle_hint(const uint32_t* guesses, const uint8_t* feedback, size_t n, uint32_t* remaining) {
+    Hello::SverdleSolver& solver = sverdle_solver();
+    solver.reset();
+    for(size_t i = 0; i < n; i++) {
+        if(feedback[i] >= SVERDLE_FEEDBACK_COUNT || !solver.apply(guesses[i], feedback[i])) {
+            *remaining = 0;
+            return -1;
+        }
+    }
+    *remaining = (uint32_t)solver.remaining();
+    return (int32_t)solver.best();
+}
+
+// Number of guesses the solver needs for the answer of a game index, or 0
+// if there is no such answer.
+EMSCRIPTEN_KEEPALIVE
+int sverdle_solve(size_t index) {
+    return sverdle_solver().solve(index);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void hmac_sha256(const uint8_t* key, size_t keylen, const uint8_t* msg, size_t msglen, uint8_t mac[SHA256_DIGEST_LENGTH]) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_HMAC_SHA256, msglen);
+    Hello::hmac_sha256(key, keylen, msg, msglen, mac);
+}
+
+// Keyed HMAC context: the padded key blocks are compressed once here, and
+// every message after that starts from the cached midstates.
+EMSCRIPTEN_KEEPALIVE
+Hello::HMAC_SHA256_CTX* hmac_sha256_create(const uint8_t* key, size_t keylen) {
+    auto ctx = (Hello::HMAC_SHA256_CTX*)secure.alloc(sizeof(Hello::HMAC_SHA256_CTX));
+    if(ctx) {
+        Hello::hmac_sha256_Init(ctx, key, keylen);
+    }
+    return ctx;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void hmac_sha256_update(Hello::HMAC_SHA256_CTX* ctx, const uint8_t* data, size_t len) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_HMAC_SHA256_UPDATE, len);
+    Hello::hmac_sha256_Update(ctx, data, len);
+}
+
+// Writes the MAC and leaves ctx ready for another message under the same key.
+EMSCRIPTEN_KEEPALIVE
+void hmac_sha256_final(Hello::HMAC_SHA256_CTX* ctx, uint8_t mac[SHA256_DIGEST_LENGTH]) {
+    Hello::hmac_sha256_Final(ctx, mac);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void hmac_sha256_destroy(Hello::HMAC_SHA256_CTX* ctx) {
+    secure.release(ctx, sizeof(Hello::HMAC_SHA256_CTX));
+}
+
+EMSCRIPTEN_KEEPALIVE
+void pbkdf2_hmac_sha256(const uint8_t* pass, size_t passlen, const uint8_t* salt, size_t saltlen, uint32_t iterations, uint8_t* key,
+                        size_t keylen) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_PBKDF2_HMAC_SHA256, passlen);
+    Hello::pbkdf2_hmac_sha256(pass, passlen, salt, saltlen, iterations, key, keylen);
+}
+
+// n passwords, one salt; keys receives n * keylen bytes.
+EMSCRIPTEN_KEEPALIVE
+void pbkdf2_hmac_sha256_batch(const uint8_t* const* passes, const size_t* passlens, size_t n, const uint8_t* salt, size_t saltlen,
+                              uint32_t iterations, uint8_t* keys, size_t keylen) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_PBKDF2_HMAC_SHA256, Hello::stats_total(passlens, n));
+    Hello::pbkdf2_hmac_sha256_batch(passes, passlens, n, salt, saltlen, iterations, keys, keylen);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void data_to_hex_into(const uint8_t* data, size_t len, char* out) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_DATA_TO_HEX, len);
+    Hello::data_to_hex(data, len, out);
+}
+
+// Returns a Hello::HexStatus; on HEX_INVALID_DIGIT *error_pos (if non-null)
+// is the index of the first bad character.
+EMSCRIPTEN_KEEPALIVE
+int hex_to_data_into(const char* hex, size_t len, uint8_t* out, size_t* error_pos) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_HEX_TO_DATA, len);
+    return Hello::hex_to_data(hex, len, out, error_pos);
+}
+
 EMSCRIPTEN_KEEPALIVE
 char* data_to_hex(const uint8_t* data, size_t len) {
-    auto d = Hello::Data(data, data + len);
-    auto hex = Hello::data_to_hex(d);
-    auto str = (char*)malloc(hex.length() + 1);
-    strcpy(str, hex.c_str());
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_DATA_TO_HEX, len);
+    auto str = (len <= (SIZE_MAX - 1) / 2) ? (char*)scratch.alloc(len * 2 + 1) : nullptr;
+    if(!str) {
+        return nullptr;
+    }
+    Hello::data_to_hex(data, len, str);
+    str[len * 2] = '\0';
     return str;
 }
 
 EMSCRIPTEN_KEEPALIVE
 bool hex_to_data(const uint8_t* utf8, size_t utf8_len, uint8_t** out, size_t* out_len) {
-    try {
-        auto hex = std::string(utf8, utf8 + utf8_len);
-        auto data = Hello::hex_to_data(hex);
-        auto buf = (uint8_t*)malloc(data.size());
-        memcpy(buf, &data[0], data.size());
-        *out = buf;
-        *out_len = data.size();
-        return true;
-    } catch(...) {
+    HELLO_STATS_SCOPE(Hello::HELLO_STAT_HEX_TO_DATA, utf8_len);
+    auto buf = (uint8_t*)scratch.alloc(utf8_len / 2);
+    if(!buf || Hello::hex_to_data((const char*)utf8, utf8_len, buf) != Hello::HEX_OK) {
         return false;
     }
+    *out = buf;
+    *out_len = utf8_len / 2;
+    return true;
+}
+
+// Instrumentation counters (see stats.hpp), or null in a build without
+// HELLO_STATS. The struct is static: reading it allocates nothing.
+EMSCRIPTEN_KEEPALIVE
+const Hello::Stats* stats_snapshot() {
+    return Hello::stats_snapshot();
+}
+
+EMSCRIPTEN_KEEPALIVE
+void stats_reset() {
+    Hello::stats_reset();
+}
+
+EMSCRIPTEN_KEEPALIVE
+const char* stats_name(int stat) {
+    return Hello::stats_name((Hello::HELLO_STAT)stat);
 }
 
 } // extern "C"
@@ -0,0 +1,45 @@
+// Checks that the baseline and SIMD128 builds of the hello module agree on
+// every SHA-256 and hex export, across block boundaries and invalid input.
+//
+//   node hello.flavors.mjs <directory holding hello.js and hello.simd.js>
+
+import path from 'node:path';
+import { pathToFileURL } from 'node:url';
+
+const dir = path.resolve(process.argv[2] ?? '.');
+const { default: instantiate_hello } = await import(pathToFileURL(path.join(dir, 'hello.loader.js')));
+
+function inputs() {
+    const result = [];
+    let seed = 1;
+    for(let len = 0; len < 300; len += (len < 130 ? 1 : 17)) {
+        const data = new Uint8Array(len);
+        for(let i = 0; i < len; i++) {
+            seed = (seed * 1103515245 + 12345) >>> 0;
+            data[i] = seed >>> 24;
+        }
+        result.push(data);
+    }
+    return result;
+}
+
+function run(mod) {
+    const data = inputs();
+    const out = [];
+    for(const d of data) {
+        const hex = mod.dataToHex(d);
+        const upper = hex.toUpperCase();
+        const broken = hex.length > 0 ? hex.slice(0, -1) + 'g' : 'g';
+        out.push(hex, mod.dataToHex(mod.sha256(hex)), mod.hexToData(upper), mod.hexToData(broken));
+    }
+    out.push(mod.sha256Batch(data).map(d => mod.dataToHex(d)));
+    return JSON.stringify(out, (k, v) => v instanceof Uint8Array ? Array.from(v) : v);
+}
+
+const baseline = run(await instantiate_hello({}, 'baseline'));
+const simd = run(await instantiate_hello({}, 'simd'));
+if(baseline !== simd) {
+    console.error('hello.flavors: baseline and SIMD128 builds disagree');
+    process.exit(1);
+}
+console.log('hello.flavors: baseline and SIMD128 builds agree');
@@ -0,0 +1,16 @@
+// Instantiates the hello module, preferring the WASM SIMD128 build when the
+// runtime can compile it and falling back to the baseline build otherwise.
+
+// (module (func (result v128) i32.const 0 i8x16.splat i8x16.popcnt))
+const SIMD128_PROBE = new Uint8Array([
+    0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+]);
+
+export function helloFlavor() {
+    return WebAssembly.validate(SIMD128_PROBE) ? 'simd' : 'baseline';
+}
+
+export default async function instantiate_hello(mod = {}, flavor = helloFlavor()) {
+    const { default: factory } = flavor === 'simd' ? await import('./hello.simd.js') : await import('./hello.js');
+    return factory(mod);
+}
@@ -1,85 +1,735 @@
 /// <reference types="emscripten" />
 
 Module['onRuntimeInitialized'] = function () {
-    Module['free'] = cwrap('free', null, ['number']);
-    Module['malloc'] = cwrap('malloc', 'number', ['number']);
-    Module['intSqrt'] = cwrap('int_sqrt', 'number', ['number']);
-    Module['add'] = cwrap('add', 'number', ['number', 'number']);
-    Module['printU8'] = cwrap('print_u8', null, ['number']);
-    Module['incrementU8'] = cwrap('increment_u8', 'number', ['number']);
-    Module['printU16'] = cwrap('print_u16', null, ['number']);
+    // Marshalling goes through the module's scratch arena (see hello.cpp):
+    // inputs are written straight into it, results are copied out with
+    // slice(), and one scratch_reset per call releases everything.
+    // Exports are called through the generated direct bindings (see
+    // bindings.mjs) rather than cwrap.
+    const bound = helloBindings();
+    const scratchReset = bound.scratch_reset;
+    const encoder = new TextEncoder();
+
+    // Returns a scratch buffer of size bytes. Throws rather than hand out a
+    // null pointer when the module cannot grow, or a short buffer when size
+    // does not fit in the module's 32-bit size_t.
+    function scratchAlloc(size) {
+        if(size > 0xffffffff) {
+            throw new RangeError('hello: scratch allocation too large');
+        }
+        const ptr = bound.scratch_alloc(size);
+        if(ptr === 0) {
+            throw new Error('hello: out of memory');
+        }
+        return ptr;
+    }
+
+    // Copies a string (as UTF-8) or a byte array into scratch memory and
+    // returns [pointer, byte length].
+    function toScratch(input) {
+        if(typeof input === 'string' && typeof SharedArrayBuffer !== 'undefined' && HEAPU8.buffer instanceof SharedArrayBuffer) {
+            // pthreads build: encodeInto refuses shared memory
+            input = encoder.encode(input);
+        }
+        if(typeof input === 'string') {
+            const capacity = input.length * 3;
+            const ptr = scratchAlloc(capacity);
+            const { written } = encoder.encodeInto(input, HEAPU8.subarray(ptr, ptr + capacity));
+            return [ptr, written];
+        }
+        const ptr = scratchAlloc(input.length);
+        HEAPU8.set(input, ptr);
+        return [ptr, input.length];
+    }
+
+    Module['free'] = _free;
+    Module['malloc'] = (size) => _malloc(size) >>> 0;
+    Module['intSqrt'] = bound.int_sqrt;
+    Module['add'] = bound.add;
+    Module['printU8'] = bound.print_u8;
+    Module['incrementU8'] = bound.increment_u8;
+    Module['printU16'] = bound.print_u16;
     Module['printU8Array'] = function(a) {
-        ccall('print_u8_array', null, ['array', 'number'], [a, a.length]);
+        try {
+            const [ptr, len] = toScratch(a);
+            bound.print_u8_array(ptr, len);
+        } finally {
+            scratchReset();
+        }
     };
+    const returnString = bound.return_string;
     Module['returnString'] = function() {
-        const ptr = ccall('return_string', 'number', []);
-        const result = UTF8ToString(ptr);
-        this.free(ptr);
-        return result;
+        try {
+            const ptr = returnString();
+            if(ptr === 0) {
+                throw new Error('hello: out of memory');
+            }
+            return UTF8ToString(ptr);
+        } finally {
+            scratchReset();
+        }
     };
+    const reverse = bound.reverse;
+    // Returns the reversed values as an Int32Array.
     Module['reverse'] = function(a) {
-        const ptr = this.malloc(a.length * 4);
-        const base = ptr / 4;
-        const aa = new Int32Array(a);
-        for(let i = 0; i < a.length; i++) {
-            HEAP32[base + i] = aa[i];
+        try {
+            const ptr = scratchAlloc(a.length * 4);
+            HEAP32.set(a, ptr >> 2);
+            reverse(ptr, a.length);
+            return HEAP32.slice(ptr >> 2, (ptr >> 2) + a.length);
+        } finally {
+            scratchReset();
         }
-        ccall('reverse', null, ['number', 'number'], [ptr, a.length]);
-        var result = [];
-        for(let i = 0; i < a.length; i++) {
-            result.push(HEAP32[base + i]);
+    };
+    const arrayReverse = bound.array_reverse;
+    const arrayBswap = bound.array_bswap;
+    const arrayMinmax = bound.array_minmax;
+    const arraySum = bound.array_sum;
+    const arrayPrefixSum = bound.array_prefix_sum;
+    // Element type codes (Hello::TypedArrayType) and the array type each
+    // one's sum comes back as.
+    const typedArrayTypes = new Map([
+        [Uint8Array, 0], [Uint16Array, 1], [Uint32Array, 2], [BigUint64Array, 3],
+        [Int8Array, 4], [Int16Array, 5], [Int32Array, 6], [BigInt64Array, 7],
+        [Float32Array, 8], [Float64Array, 9],
+    ]);
+    const typedArraySums = [BigUint64Array, BigUint64Array, BigUint64Array, BigUint64Array,
+        BigInt64Array, BigInt64Array, BigInt64Array, BigInt64Array, Float64Array, Float64Array];
+    // Results of minMax and sum. Allocated once so that a view of the heap is
+    // never detached by memory growing under it between the type check and
+    // the call.
+    const typedArrayOut = _malloc(16) >>> 0;
+    // Calls kernel(ptr, length, type) on a typed array. A view of the module's
+    // heap is passed in place; any other array goes through a scratch copy,
+    // copied back when write is set. Returns the type code.
+    function withTypedArray(a, write, kernel) {
+        const type = typedArrayTypes.get(a?.constructor);
+        if(type === undefined) {
+            throw new TypeError('expected an integer or float typed array');
+        }
+        if(a.buffer === HEAPU8.buffer) {
+            kernel(a.byteOffset, a.length, type);
+            return type;
+        }
+        try {
+            const ptr = scratchAlloc(a.byteLength);
+            const copy = new a.constructor(HEAPU8.buffer, ptr, a.length);
+            copy.set(a);
+            kernel(ptr, a.length, type);
+            if(write) {
+                a.set(copy);
+            }
+            return type;
+        } finally {
+            scratchReset();
         }
-        this.free(ptr);
-        return result;
+    }
+    // In-place kernels over typed arrays (typed_array.hpp). Views of the
+    // module's memory are worked on where they are, without a copy.
+    Module['typedArray'] = {
+        // Reverses a in place and returns it.
+        reverse(a) {
+            withTypedArray(a, true, arrayReverse);
+            return a;
+        },
+        // Reverses the bytes of every element of a (endianness) in place and
+        // returns it.
+        byteSwap(a) {
+            withTypedArray(a, true, arrayBswap);
+            return a;
+        },
+        // { min, max } of a, or undefined if a is empty. Both are NaN if a
+        // float array holds a NaN.
+        minMax(a) {
+            let found = false;
+            withTypedArray(a, false, (ptr, n, type) => {
+                found = arrayMinmax(ptr, n, type, typedArrayOut);
+            });
+            if(!found) {
+                return undefined;
+            }
+            const out = new a.constructor(HEAPU8.buffer, typedArrayOut, 2);
+            return { min: out[0], max: out[1] };
+        },
+        // Sum of the elements: a BigInt, wrapping at 64 bits, for the 64-bit
+        // arrays and a Number for the others (exact below 2^53).
+        sum(a) {
+            const type = withTypedArray(a, false, (ptr, n, type) => arraySum(ptr, n, type, typedArrayOut));
+            const sum = new typedArraySums[type](HEAPU8.buffer, typedArrayOut, 1)[0];
+            return type === 3 || type === 7 ? sum : Number(sum);
+        },
+        // Replaces a with its inclusive running sum, wrapping like the
+        // element type, and returns it.
+        prefixSum(a) {
+            withTypedArray(a, true, arrayPrefixSum);
+            return a;
+        },
     };
+    const sha256 = bound.sha256;
     Module['sha256'] = function(s) {
-        const utf8 = new TextEncoder().encode(s);
-        const inputPtr = this.malloc(utf8.length);
-        const i = new Uint8Array(HEAPU8.buffer, inputPtr, utf8.length);
-        i.set(utf8);
-        const outputPtr = this.malloc(32);
-        ccall('sha256', null, ['number', 'number', 'number'], [inputPtr, utf8.length, outputPtr]);
-        const o = new Uint8Array(new ArrayBuffer(32));
-        o.set(new Uint8Array(HEAPU8.buffer, outputPtr, 32));
-        this.free(inputPtr);
-        this.free(outputPtr);
-        return o;
+        try {
+            const [inputPtr, inputLen] = toScratch(s);
+            const outputPtr = scratchAlloc(32);
+            sha256(inputPtr, inputLen, outputPtr);
+            return HEAPU8.slice(outputPtr, outputPtr + 32);
+        } finally {
+            scratchReset();
+        }
+    };
+    const sha256d = bound.sha256d;
+    // SHA256(SHA256(s)).
+    Module['sha256d'] = function(s) {
+        try {
+            const [inputPtr, inputLen] = toScratch(s);
+            const outputPtr = scratchAlloc(32);
+            sha256d(inputPtr, inputLen, outputPtr);
+            return HEAPU8.slice(outputPtr, outputPtr + 32);
+        } finally {
+            scratchReset();
+        }
+    };
+    const sha256Create = bound.sha256_create;
+    const sha256Update = bound.sha256_update;
+    const sha256Final = bound.sha256_final;
+    const sha256Destroy = bound.sha256_destroy;
+    const secureAlloc = bound.secure_alloc;
+    const secureFree = bound.secure_free;
+    // Incremental hasher. Input is copied through one staging buffer of
+    // chunkSize bytes, so wasm memory stays O(chunkSize) however much is fed.
+    // The buffer comes from the module's secure pool and is wiped on destroy.
+    Module['Sha256'] = class {
+        constructor(chunkSize = 64 * 1024) {
+            if(!Number.isSafeInteger(chunkSize) || chunkSize <= 0 || chunkSize > 0xffffffff - 32) {
+                throw new RangeError('chunkSize must be a positive integer');
+            }
+            this.chunkSize = chunkSize;
+            this.ctx = sha256Create();
+            if(this.ctx === 0) {
+                throw new Error('hello: out of memory');
+            }
+            this.staging = secureAlloc(chunkSize + 32);
+            if(this.staging === 0) {
+                sha256Destroy(this.ctx);
+                this.ctx = 0;
+                throw new Error('hello: out of memory');
+            }
+        }
+        update(data) {
+            if(typeof data === 'string') {
+                data = encoder.encode(data);
+            }
+            for(let offset = 0; offset < data.length; offset += this.chunkSize) {
+                const chunk = data.subarray(offset, offset + this.chunkSize);
+                HEAPU8.set(chunk, this.staging);
+                sha256Update(this.ctx, this.staging, chunk.length);
+            }
+            return this;
+        }
+        digest() {
+            const digestPtr = this.staging + this.chunkSize;
+            sha256Final(this.ctx, digestPtr);
+            return HEAPU8.slice(digestPtr, digestPtr + 32);
+        }
+        destroy() {
+            sha256Destroy(this.ctx);
+            secureFree(this.staging, this.chunkSize + 32);
+            this.ctx = this.staging = 0;
+        }
+    };
+    // Hashes a Blob, a ReadableStream or any (async) iterable of Uint8Arrays
+    // chunk by chunk, yielding to the event loop between reads.
+    Module['sha256Stream'] = async function(source, chunkSize = 64 * 1024) {
+        const hasher = new Module['Sha256'](chunkSize);
+        try {
+            const stream = typeof source.stream === 'function' ? source.stream() : source;
+            if(typeof stream.getReader === 'function') {
+                const reader = stream.getReader();
+                for(;;) {
+                    const { done, value } = await reader.read();
+                    if(done) {
+                        break;
+                    }
+                    hasher.update(value);
+                }
+            } else {
+                for await (const chunk of stream) {
+                    hasher.update(chunk);
+                }
+            }
+            return hasher.digest();
+        } finally {
+            hasher.destroy();
+        }
+    };
+    const sha256Midstate = bound.sha256_midstate;
+    const SHA256_MIDSTATE_LENGTH = 105;
+    // Serialized hash state after prefix; pass it to sha256Resume or
+    // sha256ResumeBatch to hash prefix || suffix without re-reading prefix.
+    Module['sha256Midstate'] = function(prefix) {
+        try {
+            const [prefixPtr, prefixLen] = toScratch(prefix);
+            const midstatePtr = scratchAlloc(SHA256_MIDSTATE_LENGTH);
+            sha256Midstate(prefixPtr, prefixLen, midstatePtr);
+            return HEAPU8.slice(midstatePtr, midstatePtr + SHA256_MIDSTATE_LENGTH);
+        } finally {
+            scratchReset();
+        }
+    };
+    const sha256Resume = bound.sha256_resume;
+    Module['sha256Resume'] = function(midstate, suffix) {
+        try {
+            const [midstatePtr] = toScratch(midstate);
+            const [suffixPtr, suffixLen] = toScratch(suffix);
+            const digestPtr = scratchAlloc(32);
+            if(!sha256Resume(midstatePtr, suffixPtr, suffixLen, digestPtr)) {
+                throw new Error('sha256Resume: unsupported midstate');
+            }
+            return HEAPU8.slice(digestPtr, digestPtr + 32);
+        } finally {
+            scratchReset();
+        }
+    };
+    const sha256ResumeBatch = bound.sha256_resume_batch;
+    Module['sha256ResumeBatch'] = function(midstate, suffixes) {
+        try {
+            const n = suffixes.length;
+            const [midstatePtr] = toScratch(midstate);
+            const tablesPtr = scratchAlloc(n * 8 + n * 32);
+            const digestsPtr = tablesPtr + n * 8;
+            for(let i = 0; i < n; i++) {
+                const [suffixPtr, suffixLen] = toScratch(suffixes[i]);
+                HEAPU32[(tablesPtr >> 2) + i] = suffixPtr;
+                HEAPU32[(tablesPtr >> 2) + n + i] = suffixLen;
+            }
+            if(!sha256ResumeBatch(midstatePtr, tablesPtr, tablesPtr + n * 4, n, digestsPtr)) {
+                throw new Error('sha256ResumeBatch: unsupported midstate');
+            }
+            const result = [];
+            for(let i = 0; i < n; i++) {
+                result.push(HEAPU8.slice(digestsPtr + i * 32, digestsPtr + (i + 1) * 32));
+            }
+            return result;
+        } finally {
+            scratchReset();
+        }
+    };
+    const sha256Prefixed = bound.sha256_prefixed;
+    // SHA256(prefix || suffix) through the module's prefix cache.
+    Module['sha256Prefixed'] = function(prefix, suffix) {
+        try {
+            const [prefixPtr, prefixLen] = toScratch(prefix);
+            const [suffixPtr, suffixLen] = toScratch(suffix);
+            const digestPtr = scratchAlloc(32);
+            sha256Prefixed(prefixPtr, prefixLen, suffixPtr, suffixLen, digestPtr);
+            return HEAPU8.slice(digestPtr, digestPtr + 32);
+        } finally {
+            scratchReset();
+        }
+    };
+    const sha256Batch = bound.sha256_batch;
+    Module['sha256Batch'] = function(inputs) {
+        try {
+            const n = inputs.length;
+            const tablesPtr = scratchAlloc(n * 8 + n * 32);
+            const digestsPtr = tablesPtr + n * 8;
+            for(let i = 0; i < n; i++) {
+                const [dataPtr, dataLen] = toScratch(inputs[i]);
+                HEAPU32[(tablesPtr >> 2) + i] = dataPtr;
+                HEAPU32[(tablesPtr >> 2) + n + i] = dataLen;
+            }
+            sha256Batch(tablesPtr, tablesPtr + n * 4, n, digestsPtr);
+            const result = [];
+            for(let i = 0; i < n; i++) {
+                result.push(HEAPU8.slice(digestsPtr + i * 32, digestsPtr + (i + 1) * 32));
+            }
+            return result;
+        } finally {
+            scratchReset();
+        }
+    };
+    const sha256Tree = bound.sha256_tree;
+    // Returns { root, leaves }: the tree root and every leaf digest
+    // (leafCount * 32 bytes) for later range checks.
+    Module['sha256Tree'] = function(data, leafSize = 1024 * 1024) {
+        if(!Number.isSafeInteger(leafSize) || leafSize <= 0 || leafSize > 0xffffffff) {
+            throw new RangeError('leafSize must be a positive integer');
+        }
+        try {
+            const [inputPtr, inputLen] = toScratch(data);
+            const leafCount = Math.max(1, Math.ceil(inputLen / leafSize));
+            const rootPtr = scratchAlloc(32 + leafCount * 32);
+            if(!sha256Tree(inputPtr, inputLen, leafSize, rootPtr, rootPtr + 32)) {
+                throw new RangeError('leafSize must be a positive integer');
+            }
+            return {
+                root: HEAPU8.slice(rootPtr, rootPtr + 32),
+                leaves: HEAPU8.slice(rootPtr + 32, rootPtr + 32 + leafCount * 32),
+            };
+        } finally {
+            scratchReset();
+        }
     };
+    const sha256PowSearch = bound.sha256_pow_search;
+    const sha256PowCheck = bound.sha256_pow_check;
+    // 64-bit values cross as two 32-bit halves in memory.
+    function writeU64(ptr, value) {
+        const big = BigInt.asUintN(64, BigInt(value));
+        HEAPU32[ptr >> 2] = Number(big & 0xffffffffn);
+        HEAPU32[(ptr >> 2) + 1] = Number(big >> 32n);
+    }
+    function readU64(ptr) {
+        return BigInt(HEAPU32[ptr >> 2]) | (BigInt(HEAPU32[(ptr >> 2) + 1]) << 32n);
+    }
+    // Hashcash-style proof of work (sha256_pow.hpp): nonce solves prefix
+    // when SHA256(prefix || nonce as 8 big-endian bytes) starts with `bits`
+    // zero bits.
+    Module['sha256Pow'] = {
+        // Smallest solving nonce in [start, start + count), searched on every
+        // core in a pthreads build. Returns { nonce, digest, hashes, seconds,
+        // threads, hashesPerSecond, perCore }; nonce (a BigInt) and digest
+        // are null if no nonce in the range solves it.
+        search(prefix, bits, { start = 0n, count = 1n << 32n } = {}) {
+            try {
+                const [prefixPtr, prefixLen] = toScratch(prefix);
+                const rangePtr = scratchAlloc(16 + 64);
+                const resultPtr = rangePtr + 16;
+                writeU64(rangePtr, start);
+                writeU64(rangePtr + 8, count);
+                const found = sha256PowSearch(prefixPtr, prefixLen, bits, rangePtr, resultPtr);
+                const hashes = Number(readU64(resultPtr + 8));
+                const seconds = new Float64Array(HEAPU8.buffer, resultPtr + 16, 1)[0];
+                const threads = HEAPU32[(resultPtr + 28) >> 2];
+                const hashesPerSecond = seconds > 0 ? hashes / seconds : 0;
+                return {
+                    nonce: found ? readU64(resultPtr) : null,
+                    digest: found ? HEAPU8.slice(resultPtr + 32, resultPtr + 64) : null,
+                    hashes, seconds, threads, hashesPerSecond,
+                    perCore: threads ? hashesPerSecond / threads : 0,
+                };
+            } finally {
+                scratchReset();
+            }
+        },
+        // Whether nonce (a Number or BigInt) solves prefix at bits.
+        check(prefix, nonce, bits) {
+            try {
+                const [prefixPtr, prefixLen] = toScratch(prefix);
+                const noncePtr = scratchAlloc(8 + 32);
+                writeU64(noncePtr, nonce);
+                return sha256PowCheck(prefixPtr, prefixLen, noncePtr, bits, noncePtr + 8);
+            } finally {
+                scratchReset();
+            }
+        },
+    };
+    const chunkerCreate = bound.chunker_create;
+    const chunkerUpdate = bound.chunker_update;
+    const chunkerFinish = bound.chunker_finish;
+    const chunkerDestroy = bound.chunker_destroy;
+    const CHUNK_RECORD_LENGTH = 48; // u64 offset, u32 length, u32 reserved, digest
+    // Content-defined chunker (see sha256_cdc.hpp). Feed an input of any size
+    // in pieces with update(); finish() returns the manifest, an array of
+    // { offset, length, digest }, and readies the chunker for another input.
+    // Unchanged regions of an edited file come out as the same chunks.
+    Module['Chunker'] = class {
+        constructor({ minSize = 16 * 1024, avgSize = 64 * 1024, maxSize = 256 * 1024 } = {}) {
+            this.chunker = chunkerCreate(minSize, avgSize, maxSize);
+            if(!this.chunker) {
+                throw new RangeError('invalid chunk sizes');
+            }
+        }
+        update(data) {
+            try {
+                const [dataPtr, dataLen] = toScratch(data);
+                chunkerUpdate(this.chunker, dataPtr, dataLen);
+            } finally {
+                scratchReset();
+            }
+            return this;
+        }
+        finish() {
+            try {
+                const countPtr = scratchAlloc(4);
+                const recordsPtr = chunkerFinish(this.chunker, countPtr);
+                const manifest = [];
+                for(let i = 0; i < HEAPU32[countPtr >> 2]; i++) {
+                    const at = recordsPtr + i * CHUNK_RECORD_LENGTH;
+                    manifest.push({
+                        offset: HEAPU32[at >> 2] + HEAPU32[(at + 4) >> 2] * 0x100000000,
+                        length: HEAPU32[(at + 8) >> 2],
+                        digest: HEAPU8.slice(at + 16, at + 48),
+                    });
+                }
+                return manifest;
+            } finally {
+                scratchReset();
+            }
+        }
+        destroy() {
+            chunkerDestroy(this.chunker);
+            this.chunker = 0;
+        }
+    };
+    const chunkIndexCreate = bound.chunk_index_create;
+    const chunkIndexAdd = bound.chunk_index_add;
+    const chunkIndexDestroy = bound.chunk_index_destroy;
+    // Digests of chunks already stored. add(manifest) records a manifest
+    // and returns one boolean per entry: true if that chunk was known, i.e.
+    // does not need uploading again.
+    Module['ChunkIndex'] = class {
+        constructor() {
+            this.index = chunkIndexCreate();
+        }
+        add(manifest) {
+            try {
+                const n = manifest.length;
+                const recordsPtr = scratchAlloc(n * CHUNK_RECORD_LENGTH);
+                const knownPtr = scratchAlloc(n);
+                manifest.forEach(({ length, digest }, i) => {
+                    const at = recordsPtr + i * CHUNK_RECORD_LENGTH;
+                    HEAPU32[(at + 8) >> 2] = length;
+                    HEAPU8.set(digest, at + 16);
+                });
+                chunkIndexAdd(this.index, recordsPtr, n, knownPtr);
+                return Array.from(HEAPU8.subarray(knownPtr, knownPtr + n), (known) => known !== 0);
+            } finally {
+                scratchReset();
+            }
+        }
+        destroy() {
+            chunkIndexDestroy(this.index);
+            this.index = 0;
+        }
+    };
+    const sverdleAnswer = bound.sverdle_answer;
+    const sverdleAllowed = bound.sverdle_allowed;
+    const sverdleEnter = bound.sverdle_enter;
+    const sverdleHint = bound.sverdle_hint;
+    const sverdleSolve = bound.sverdle_solve;
+    // Packs a five-letter lowercase word as sverdle.hpp describes, or
+    // returns -1.
+    function sverdlePack(word) {
+        if(word.length !== 5) {
+            return -1;
+        }
+        let packed = 0;
+        for(let i = 4; i >= 0; i--) {
+            const letter = word.charCodeAt(i) - 97;
+            if(letter < 0 || letter > 25) {
+                return -1;
+            }
+            packed = (packed << 5) | letter;
+        }
+        return packed;
+    }
+    // Feedback strings ('x' exact, 'c' close, '_' miss) for every feedback
+    // byte, built once so scoring a guess allocates nothing.
+    const sverdleFeedback = [];
+    for(let code = 0; code < 243; code++) {
+        let text = '';
+        for(let i = 0, rest = code; i < 5; i++, rest = Math.floor(rest / 3)) {
+            text += '_cx'[rest % 3];
+        }
+        sverdleFeedback.push(text);
+    }
+    const sverdleFeedbackCodes = new Map(sverdleFeedback.map((text, code) => [text, code]));
+    function sverdleUnpack(packed) {
+        let word = '';
+        for(let i = 0; i < 5; i++) {
+            word += String.fromCharCode(97 + ((packed >> (5 * i)) & 31));
+        }
+        return word;
+    }
+    // The Sverdle engine (sverdle.cpp) for src/routes/sverdle/game.ts.
+    Module['sverdle'] = {
+        // Number of possible answers; a game's index is below it.
+        count: bound.sverdle_answer_count(),
+        // The answer for a game index, or undefined.
+        answer(index) {
+            const packed = Number.isInteger(index) && index >= 0 ? sverdleAnswer(index) : -1;
+            return packed < 0 ? undefined : sverdleUnpack(packed);
+        },
+        allowed(word) {
+            return sverdleAllowed(sverdlePack(word));
+        },
+        // Feedback like '__x_c' for guess against the answer of a game
+        // index, or null if the guess is not an allowed word.
+        enter(guess, index) {
+            const feedback = Number.isInteger(index) && index >= 0 ? sverdleEnter(sverdlePack(guess), index) : -1;
+            return feedback < 0 ? null : sverdleFeedback[feedback];
+        },
+        // Best next guess given the guesses played so far and the feedback
+        // strings they got (as from enter), with the number of answers still
+        // possible: { guess, remaining }. guess is null if the guesses are not
+        // allowed words or no answer fits them.
+        hint(guesses, feedback) {
+            const n = Math.min(guesses.length, feedback.length);
+            try {
+                const guessesPtr = scratchAlloc(n * 4 + 4);
+                const remainingPtr = guessesPtr + n * 4;
+                const feedbackPtr = scratchAlloc(n);
+                for(let i = 0; i < n; i++) {
+                    const code = sverdleFeedbackCodes.get(feedback[i]);
+                    HEAPU32[(guessesPtr >> 2) + i] = sverdlePack(guesses[i]);
+                    HEAPU8[feedbackPtr + i] = code === undefined ? 255 : code;
+                }
+                const guess = sverdleHint(guessesPtr, feedbackPtr, n, remainingPtr);
+                return { guess: guess < 0 ? null : sverdleUnpack(guess), remaining: HEAPU32[remainingPtr >> 2] };
+            } finally {
+                scratchReset();
+            }
+        },
+        // Guesses the solver needs for the answer of a game index, or 0.
+        solve(index) {
+            return Number.isInteger(index) && index >= 0 ? sverdleSolve(index) : 0;
+        },
+    };
+    const hmacSha256 = bound.hmac_sha256;
+    Module['hmacSha256'] = function(key, message) {
+        try {
+            const [keyPtr, keyLen] = toScratch(key);
+            const [messagePtr, messageLen] = toScratch(message);
+            const macPtr = scratchAlloc(32);
+            hmacSha256(keyPtr, keyLen, messagePtr, messageLen, macPtr);
+            return HEAPU8.slice(macPtr, macPtr + 32);
+        } finally {
+            scratchReset();
+        }
+    };
+    const hmacCreate = bound.hmac_sha256_create;
+    const hmacUpdate = bound.hmac_sha256_update;
+    const hmacFinal = bound.hmac_sha256_final;
+    const hmacDestroy = bound.hmac_sha256_destroy;
+    // Keyed HMAC that can sign any number of messages; the key schedule is
+    // paid once, in the constructor.
+    Module['HmacSha256'] = class {
+        constructor(key) {
+            try {
+                const [keyPtr, keyLen] = toScratch(key);
+                this.ctx = hmacCreate(keyPtr, keyLen);
+            } finally {
+                scratchReset();
+            }
+        }
+        update(data) {
+            try {
+                const [dataPtr, dataLen] = toScratch(data);
+                hmacUpdate(this.ctx, dataPtr, dataLen);
+            } finally {
+                scratchReset();
+            }
+            return this;
+        }
+        digest() {
+            try {
+                const macPtr = scratchAlloc(32);
+                hmacFinal(this.ctx, macPtr);
+                return HEAPU8.slice(macPtr, macPtr + 32);
+            } finally {
+                scratchReset();
+            }
+        }
+        destroy() {
+            hmacDestroy(this.ctx);
+            this.ctx = 0;
+        }
+    };
+    const pbkdf2 = bound.pbkdf2_hmac_sha256;
+    Module['pbkdf2HmacSha256'] = function(password, salt, iterations, keyLength = 32) {
+        try {
+            const [passwordPtr, passwordLen] = toScratch(password);
+            const [saltPtr, saltLen] = toScratch(salt);
+            const keyPtr = scratchAlloc(keyLength);
+            pbkdf2(passwordPtr, passwordLen, saltPtr, saltLen, iterations, keyPtr, keyLength);
+            return HEAPU8.slice(keyPtr, keyPtr + keyLength);
+        } finally {
+            scratchReset();
+        }
+    };
+    const pbkdf2Batch = bound.pbkdf2_hmac_sha256_batch;
+    // Derives one key per password with a shared salt, the passwords running
+    // side by side on SIMD lanes. Returns an array of Uint8Arrays.
+    Module['pbkdf2HmacSha256Batch'] = function(passwords, salt, iterations, keyLength = 32) {
+        try {
+            const n = passwords.length;
+            const tablesPtr = scratchAlloc(n * 8);
+            for(let i = 0; i < n; i++) {
+                const [passwordPtr, passwordLen] = toScratch(passwords[i]);
+                HEAPU32[(tablesPtr >> 2) + i] = passwordPtr;
+                HEAPU32[(tablesPtr >> 2) + n + i] = passwordLen;
+            }
+            const [saltPtr, saltLen] = toScratch(salt);
+            const keysPtr = scratchAlloc(n * keyLength);
+            pbkdf2Batch(tablesPtr, tablesPtr + n * 4, n, saltPtr, saltLen, iterations, keysPtr, keyLength);
+            const result = [];
+            for(let i = 0; i < n; i++) {
+                result.push(HEAPU8.slice(keysPtr + i * keyLength, keysPtr + (i + 1) * keyLength));
+            }
+            return result;
+        } finally {
+            scratchReset();
+        }
+    };
+    const dataToHexInto = bound.data_to_hex_into;
     Module['dataToHex'] = function(data) {
-        const inputPtr = this.malloc(data.length);
-        const i = new Uint8Array(HEAPU8.buffer, inputPtr, data.length);
-        i.set(data);
-        const outputPtr = ccall('data_to_hex', 'number', ['number', 'number'], [inputPtr, data.length]);
-        const result = UTF8ToString(outputPtr);
-        this.free(inputPtr);
-        this.free(outputPtr);
-        return result;
+        try {
+            const [inputPtr, inputLen] = toScratch(data);
+            const outputPtr = scratchAlloc(inputLen * 2);
+            dataToHexInto(inputPtr, inputLen, outputPtr);
+            return UTF8ToString(outputPtr, inputLen * 2);
+        } finally {
+            scratchReset();
+        }
     };
+    const hexToDataInto = bound.hex_to_data_into;
     Module['hexToData'] = function(hex) {
-        const utf8 = new TextEncoder().encode(hex);
-        const inputPtr = this.malloc(utf8.length);
-        const i = new Uint8Array(HEAPU8.buffer, inputPtr, utf8.length);
-        i.set(utf8);
-
-        const outputPtrPtr = this.malloc(4);
-        const outputLenPtr = this.malloc(4);
-        const outputPtr = 0;
-
-        const success = ccall('hex_to_data', 'boolean', ['number', 'number', 'number', 'number'], [inputPtr, utf8.length, outputPtrPtr, outputLenPtr]);
-
-        let result = null;
-        if(success) {
-            const outputLen = new Uint32Array(HEAPU8.buffer, outputLenPtr, 1)[0];
-            const outputPtr = new Uint32Array(HEAPU8.buffer, outputPtrPtr, 1)[0];
-            const output = new Uint8Array(HEAPU8.buffer, outputPtr, outputLen);
-            result = new Uint8Array(new ArrayBuffer(outputLen));
-            result.set(output);
+        try {
+            const [inputPtr, inputLen] = toScratch(hex);
+            const outputPtr = scratchAlloc(inputLen >> 1);
+            if(hexToDataInto(inputPtr, inputLen, outputPtr, 0) !== 0) {
+                return null;
+            }
+            return HEAPU8.slice(outputPtr, outputPtr + (inputLen >> 1));
+        } finally {
+            scratchReset();
         }
-
-        this.free(inputPtr);
-        this.free(outputLenPtr);
-        this.free(outputPtr);
-        this.free(outputPtrPtr);
-        return result;
     };
+    const statsSnapshot = bound.stats_snapshot;
+    const statsName = bound.stats_name;
+    let statsNames = null;
+    // Counters of a build made with HELLO_STATS=1 (see stats.hpp), read
+    // straight out of the module's static Stats struct, or null if the build
+    // has no instrumentation. Time spent in a wrapper beyond an export's ns
+    // is marshalling.
+    Module['stats'] = function() {
+        const ptr = statsSnapshot();
+        if(!ptr) {
+            return null;
+        }
+        const u32 = HEAPU32;
+        const base = ptr >> 2;
+        const u64 = (i) => u32[base + i] + u32[base + i + 1] * 0x100000000;
+        const count = u32[base + 1];
+        if(!statsNames) {
+            statsNames = [];
+            for(let i = 0; i < count; i++) {
+                statsNames.push(UTF8ToString(statsName(i)));
+            }
+        }
+        const exports = {};
+        for(let i = 0; i < count; i++) {
+            const at = 12 + i * 6;
+            exports[statsNames[i]] = { calls: u64(at), bytes: u64(at + 2), ns: u64(at + 4) };
+        }
+        return {
+            version: u32[base],
+            mallocs: u64(2),
+            frees: u64(4),
+            heapBytes: u64(6),
+            heapPeak: u64(8),
+            heapTop: u64(10),
+            exports,
+        };
+    };
+    Module['statsReset'] = bound.stats_reset;
 }
@@ -0,0 +1,120 @@
+// Worker side of hello.async.js: hosts one instance of the hello module and
+// answers batches of requests. Runs as a module Worker in the browser and
+// under node:worker_threads.
+//
+// Each message is an array of requests { id, op, args }; the reply is one
+// array of { id, result } or { id, error } in the same order. Result bytes
+// are fresh slices of the wasm heap and are transferred back, not copied.
+
+import instantiate_hello from './hello.loader.js';
+
+const port = typeof WorkerGlobalScope !== 'undefined' ? self : (await import('node:worker_threads')).parentPort;
+const ready = instantiate_hello();
+// A failed load is reported by handle(), once per request; without this it
+// would also be an unhandled rejection, which kills a Node worker.
+ready.catch(() => {});
+
+function concat(parts) {
+    const out = new Uint8Array(parts.reduce((n, p) => n + p.length, 0));
+    let offset = 0;
+    for(const p of parts) {
+        out.set(p, offset);
+        offset += p.length;
+    }
+    return out;
+}
+
+// Ops that hello.async.js coalesces: each takes the list of every request's
+// args and answers them all, with as few wasm calls as the exports allow.
+const batched = {
+    // One sha256_batch call.
+    sha256(mod, list) {
+        return mod.sha256Batch(list.map(([data]) => data));
+    },
+    // One data_to_hex_into call over the concatenated inputs.
+    dataToHex(mod, list) {
+        const hex = mod.dataToHex(concat(list.map(([data]) => data)));
+        const out = [];
+        let offset = 0;
+        for(const [data] of list) {
+            out.push(hex.slice(offset, offset + data.length * 2));
+            offset += data.length * 2;
+        }
+        return out;
+    },
+    // One hex_to_data_into call if every input is valid; otherwise each is
+    // decoded on its own so only the invalid ones come back null.
+    hexToData(mod, list) {
+        const all = list.every(([hex]) => hex.length % 2 === 0) ? mod.hexToData(list.map(([hex]) => hex).join('')) : null;
+        if(!all) {
+            return list.map(([hex]) => mod.hexToData(hex));
+        }
+        const out = [];
+        let offset = 0;
+        for(const [hex] of list) {
+            out.push(all.slice(offset, offset + hex.length / 2));
+            offset += hex.length / 2;
+        }
+        return out;
+    },
+};
+
+const single = {
+    sha256d: (mod, [data]) => mod.sha256d(data),
+    sha256Tree: (mod, [data, leafSize]) => mod.sha256Tree(data, leafSize),
+    hmacSha256: (mod, [message, key]) => mod.hmacSha256(key, message),
+    pbkdf2HmacSha256: (mod, [password, salt, iterations, keyLength]) => mod.pbkdf2HmacSha256(password, salt, iterations, keyLength),
+};
+
+function transferables(value, list) {
+    if(value instanceof Uint8Array) {
+        list.add(value.buffer);
+    } else if(value && typeof value === 'object') {
+        for(const v of Object.values(value)) {
+            transferables(v, list);
+        }
+    }
+    return list;
+}
+
+async function handle(requests) {
+    let mod;
+    try {
+        mod = await ready;
+    } catch(e) {
+        const error = `hello: module failed to load: ${e?.message ?? e}`;
+        port.postMessage(requests.map(({ id }) => ({ id, error })));
+        return;
+    }
+    const replies = new Array(requests.length);
+    const groups = new Map();
+    requests.forEach((request, i) => {
+        if(batched[request.op]) {
+            if(!groups.has(request.op)) {
+                groups.set(request.op, []);
+            }
+            groups.get(request.op).push(i);
+        } else {
+            try {
+                replies[i] = { id: request.id, result: single[request.op](mod, request.args) };
+            } catch(e) {
+                replies[i] = { id: request.id, error: String(e?.message ?? e) };
+            }
+        }
+    });
+    for(const [op, indices] of groups) {
+        try {
+            const results = batched[op](mod, indices.map((i) => requests[i].args));
+            indices.forEach((i, k) => (replies[i] = { id: requests[i].id, result: results[k] }));
+        } catch(e) {
+            indices.forEach((i) => (replies[i] = { id: requests[i].id, error: String(e?.message ?? e) }));
+        }
+    }
+    port.postMessage(replies, [...transferables(replies, new Set())]);
+}
+
+if(typeof WorkerGlobalScope !== 'undefined') {
+    self.onmessage = (e) => handle(e.data);
+} else {
+    port.on('message', handle);
+}
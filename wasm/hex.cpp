@@ -1,54 +1,108 @@
+#include <stdexcept>
 #include <string>
+#include <string.h>
 #include "hex.hpp"
+#include "hex_simd.hpp"
 
 using namespace std;
 
 namespace Hello {
 
-string byte_to_hex(uint8_t byte) {
-    auto hex = "0123456789abcdef";
-    string result;
-    result.append(1, hex[(byte >> 4) & 0xF]);
-    result.append(1, hex[byte & 0xF]);
-    return result;
-}
+// Encoding reads both digits of a byte from a 512-byte pair table. Decoding
+// maps each character through a 256-entry table whose invalid entries have
+// the high bit set, so a block needs a single OR-reduced check.
+#define HEX_INVALID 0x80
+#define HEX_BLOCK 16
 
-string data_to_hex(const Data& in) {
-    string result;
-    for(auto c: in) {
-        result.append(byte_to_hex(c));
+struct HexTables {
+    char pairs[512];
+    uint8_t values[256];
+
+    constexpr HexTables() : pairs(), values() {
+        const char digits[] = "0123456789abcdef";
+        for(int i = 0; i < 256; i++) {
+            pairs[i * 2] = digits[i >> 4];
+            pairs[i * 2 + 1] = digits[i & 0xF];
+            values[i] = HEX_INVALID;
+        }
+        for(int i = 0; i < 10; i++) {
+            values['0' + i] = i;
+        }
+        for(int i = 0; i < 6; i++) {
+            values['a' + i] = 10 + i;
+            values['A' + i] = 10 + i;
+        }
+    }
+};
+
+static constexpr HexTables hex_tables;
+
+void data_to_hex(const uint8_t* in, size_t len, char* out) {
+    const HexKernel* kernel = hex_kernel();
+    size_t i = kernel ? kernel->encode(in, len, out) : 0;
+    for(; i < len; i++) {
+        memcpy(out + i * 2, &hex_tables.pairs[in[i] * 2], 2);
     }
-    return result;
 }
 
-uint8_t hex_digit_to_bin(char hex) {
-    if (hex >= '0' && hex <= '9') {
-        return hex - '0';
-    } else if (hex >= 'A' && hex <= 'F') {
-        return hex - 'A' + 10;
-    } else if (hex >= 'a' && hex <= 'f') {
-        return hex - 'a' + 10;
-    } else {
-        throw domain_error("Invalid hex digit");
+// Decodes count bytes without early exit; returns the OR of every nibble
+// value, which has HEX_INVALID set if any character was bad.
+static uint8_t hex_decode_block(const char* hex, size_t count, uint8_t* out) {
+    uint8_t check = 0;
+    for(size_t i = 0; i < count; i++) {
+        uint8_t hi = hex_tables.values[(uint8_t)hex[i * 2]];
+        uint8_t lo = hex_tables.values[(uint8_t)hex[i * 2 + 1]];
+        check |= hi | lo;
+        out[i] = (uint8_t)((hi << 4) | (lo & 0xF));
     }
+    return check;
 }
 
-Data hex_to_data(const string& hex) {
-    Data result;
+static size_t hex_find_invalid(const char* hex, size_t len) {
+    size_t i = 0;
+    while(i < len && hex_tables.values[(uint8_t)hex[i]] != HEX_INVALID) {
+        i++;
+    }
+    return i;
+}
 
-    auto len = hex.length();
+HexStatus hex_to_data(const char* hex, size_t len, uint8_t* out, size_t* error_pos) {
     if(len % 2 != 0) {
-        throw domain_error("Hex string must have even number of characters.");
+        return HEX_ODD_LENGTH;
     }
-    auto count = len / 2;
-    result.reserve(count);
-    for(auto i = 0; i < count; i++) {
-        auto b1 = hex_digit_to_bin(hex[i * 2]);
-        auto b2 = hex_digit_to_bin(hex[i * 2 + 1]);
-        result.push_back((b1 << 4) | b2);
+    size_t count = len / 2;
+    // The vector kernel stops before a block with a bad character; the
+    // scalar loop then reaches it and reports its position.
+    const HexKernel* kernel = hex_kernel();
+    size_t i = kernel ? kernel->decode(hex, count, out) : 0;
+    for(; i < count; i += HEX_BLOCK) {
+        size_t block = count - i < HEX_BLOCK ? count - i : HEX_BLOCK;
+        if(hex_decode_block(hex + i * 2, block, out + i) & HEX_INVALID) {
+            if(error_pos) {
+                *error_pos = i * 2 + hex_find_invalid(hex + i * 2, block * 2);
+            }
+            return HEX_INVALID_DIGIT;
+        }
     }
+    return HEX_OK;
+}
 
+string data_to_hex(const Data& in) {
+    string result(in.size() * 2, '\0');
+    data_to_hex(in.data(), in.size(), &result[0]);
     return result;
 }
 
+Data hex_to_data(const string& hex) {
+    Data result(hex.length() / 2);
+    switch(hex_to_data(hex.data(), hex.length(), result.data())) {
+    case HEX_ODD_LENGTH:
+        throw domain_error("Hex string must have even number of characters.");
+    case HEX_INVALID_DIGIT:
+        throw domain_error("Invalid hex digit");
+    default:
+        return result;
+    }
+}
+
 }
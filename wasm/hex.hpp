@@ -2,10 +2,41 @@
 #define __HEX_H__
 
 #include "data.hpp"
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
 
 namespace Hello {
 
+enum HexStatus {
+    HEX_OK = 0,
+    HEX_ODD_LENGTH = 1,
+    HEX_INVALID_DIGIT = 2,
+};
+
+// Writes the 2 * len lowercase hex digits of in to out, without a terminator.
+void data_to_hex(const uint8_t* in, size_t len, char* out);
+
+// Decodes len hex digits (either case) into len / 2 bytes at out. On
+// HEX_INVALID_DIGIT, *error_pos receives the index of the first bad
+// character and out holds an unspecified prefix.
+HexStatus hex_to_data(const char* hex, size_t len, uint8_t* out, size_t* error_pos = nullptr);
+
+// Vector kernels behind the span functions. The best one the CPU supports is
+// picked on first use; hex_set_backend(HEX_BACKEND_SCALAR) forces the table
+// code, e.g. to check the kernels against it.
+enum HexBackend {
+    HEX_BACKEND_SCALAR = 0,
+    HEX_BACKEND_SSSE3 = 1,
+    HEX_BACKEND_AVX2 = 2,
+    HEX_BACKEND_SIMD128 = 3,
+};
+
+HexBackend hex_backend();
+bool hex_backend_supported(HexBackend backend);
+bool hex_set_backend(HexBackend backend);
+
+// Thin wrappers over the span versions; hex_to_data throws domain_error.
 std::string data_to_hex(const Data& in);
 Data hex_to_data(const std::string& hex);
 
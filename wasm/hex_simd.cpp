@@ -0,0 +1,222 @@
+#include "hex_simd.hpp"
+
+#include <atomic>
+
+#include "cpu.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HELLO_HEX_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace Hello {
+
+/*** SSSE3 / AVX2 *****************************************************/
+/*
+ * Encode splits every byte into nibbles and maps them to digits with a
+ * PSHUFB table lookup, then interleaves high and low digits. Decode
+ * range-checks '0'-'9' and (c | 0x20) in 'a'-'f' with unsigned min compares,
+ * and PMADDUBSW folds each digit pair into hi * 16 + lo before packing.
+ */
+#ifdef HELLO_HEX_X86
+__attribute__((target("ssse3"))) static inline __m128i hex_nibbles_ssse3(__m128i c, __m128i* valid) {
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    *valid = _mm_and_si128(*valid, _mm_or_si128(is_digit, is_alpha));
+    return _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_andnot_si128(is_digit, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+__attribute__((target("ssse3"))) static size_t hex_encode_ssse3(const uint8_t* in, size_t len, char* out) {
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), low_nibble));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, low_nibble));
+        _mm_storeu_si128((__m128i*)(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3"))) static size_t hex_decode_ssse3(const char* hex, size_t count, uint8_t* out) {
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m128i valid = _mm_set1_epi8(-1);
+        __m128i a = hex_nibbles_ssse3(_mm_loadu_si128((const __m128i*)(hex + i * 2)), &valid);
+        __m128i b = hex_nibbles_ssse3(_mm_loadu_si128((const __m128i*)(hex + i * 2 + 16)), &valid);
+        if(_mm_movemask_epi8(valid) != 0xFFFF) {
+            break;
+        }
+        __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+        _mm_storeu_si128((__m128i*)(out + i), bytes);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) static inline __m256i hex_nibbles_avx2(__m256i c, __m256i* valid) {
+    __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+    *valid = _mm256_and_si256(*valid, _mm256_or_si256(is_digit, is_alpha));
+    return _mm256_blendv_epi8(_mm256_add_epi8(alpha, _mm256_set1_epi8(10)), digit, is_digit);
+}
+
+__attribute__((target("avx2"))) static size_t hex_encode_avx2(const uint8_t* in, size_t len, char* out) {
+    const __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                            '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+    size_t i = 0;
+    for(; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+        __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibble));
+        __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(v, low_nibble));
+        /* Unpacks work within 128-bit lanes; put the halves back in order. */
+        __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i*)(out + i * 2), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + i * 2 + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i + hex_encode_ssse3(in + i, len - i, out + i * 2);
+}
+
+__attribute__((target("avx2"))) static size_t hex_decode_avx2(const char* hex, size_t count, uint8_t* out) {
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t i = 0;
+    for(; i + 32 <= count; i += 32) {
+        __m256i valid = _mm256_set1_epi8(-1);
+        __m256i a = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(hex + i * 2)), &valid);
+        __m256i b = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i*)(hex + i * 2 + 32)), &valid);
+        if(_mm256_movemask_epi8(valid) != -1) {
+            break;
+        }
+        __m256i bytes = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_permute4x64_epi64(bytes, 0xD8));
+    }
+    return i + hex_decode_ssse3(hex + i * 2, count - i, out + i);
+}
+
+static const HexKernel hex_kernel_ssse3 = {hex_encode_ssse3, hex_decode_ssse3};
+static const HexKernel hex_kernel_avx2 = {hex_encode_avx2, hex_decode_avx2};
+#endif
+
+/*** WASM SIMD128 *****************************************************/
+#ifdef __wasm_simd128__
+static inline v128_t hex_nibbles_simd128(v128_t c, v128_t* valid) {
+    v128_t digit = wasm_i8x16_sub(c, wasm_i8x16_splat('0'));
+    v128_t alpha = wasm_i8x16_sub(wasm_v128_or(c, wasm_i8x16_splat(0x20)), wasm_i8x16_splat('a'));
+    v128_t is_digit = wasm_u8x16_le(digit, wasm_i8x16_splat(9));
+    v128_t is_alpha = wasm_u8x16_le(alpha, wasm_i8x16_splat(5));
+    *valid = wasm_v128_and(*valid, wasm_v128_or(is_digit, is_alpha));
+    return wasm_v128_bitselect(digit, wasm_i8x16_add(alpha, wasm_i8x16_splat(10)), is_digit);
+}
+
+static size_t hex_encode_simd128(const uint8_t* in, size_t len, char* out) {
+    const v128_t digits = wasm_v128_load("0123456789abcdef");
+    size_t i = 0;
+    for(; i + 16 <= len; i += 16) {
+        v128_t v = wasm_v128_load(in + i);
+        v128_t hi = wasm_i8x16_swizzle(digits, wasm_u8x16_shr(v, 4));
+        v128_t lo = wasm_i8x16_swizzle(digits, wasm_v128_and(v, wasm_i8x16_splat(0x0f)));
+        wasm_v128_store(out + i * 2, wasm_i8x16_shuffle(hi, lo, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23));
+        wasm_v128_store(out + i * 2 + 16, wasm_i8x16_shuffle(hi, lo, 8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31));
+    }
+    return i;
+}
+
+static size_t hex_decode_simd128(const char* hex, size_t count, uint8_t* out) {
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        v128_t valid = wasm_i8x16_splat(-1);
+        v128_t a = hex_nibbles_simd128(wasm_v128_load(hex + i * 2), &valid);
+        v128_t b = hex_nibbles_simd128(wasm_v128_load(hex + i * 2 + 16), &valid);
+        if(!wasm_i8x16_all_true(valid)) {
+            break;
+        }
+        v128_t hi = wasm_i8x16_shuffle(a, b, 0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        v128_t lo = wasm_i8x16_shuffle(a, b, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+        wasm_v128_store(out + i, wasm_v128_or(wasm_i8x16_shl(hi, 4), lo));
+    }
+    return i;
+}
+
+static const HexKernel hex_kernel_simd128 = {hex_encode_simd128, hex_decode_simd128};
+#endif
+
+/*** DISPATCH *********************************************************/
+static std::atomic<int> hex_backend_current(-1);
+
+bool hex_backend_supported(HexBackend backend) {
+    switch(backend) {
+    case HEX_BACKEND_SCALAR:
+        return true;
+#ifdef HELLO_HEX_X86
+    case HEX_BACKEND_SSSE3:
+        return cpu_features().ssse3;
+    case HEX_BACKEND_AVX2:
+        return cpu_features().avx2 && cpu_features().ssse3;
+#endif
+#ifdef __wasm_simd128__
+    case HEX_BACKEND_SIMD128:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+bool hex_set_backend(HexBackend backend) {
+    if(!hex_backend_supported(backend)) {
+        return false;
+    }
+    hex_backend_current.store(backend, std::memory_order_relaxed);
+    return true;
+}
+
+HexBackend hex_backend() {
+    int backend = hex_backend_current.load(std::memory_order_relaxed);
+    if(backend >= 0) {
+        return (HexBackend)backend;
+    }
+    const HexBackend preferred[] = {HEX_BACKEND_AVX2, HEX_BACKEND_SSSE3, HEX_BACKEND_SIMD128};
+    for(auto candidate: preferred) {
+        if(hex_backend_supported(candidate)) {
+            backend = candidate;
+            break;
+        }
+    }
+    if(backend < 0) {
+        backend = HEX_BACKEND_SCALAR;
+    }
+    int unset = -1;
+    hex_backend_current.compare_exchange_strong(unset, backend, std::memory_order_relaxed);
+    return (HexBackend)hex_backend_current.load(std::memory_order_relaxed);
+}
+
+const HexKernel* hex_kernel() {
+    switch(hex_backend()) {
+#ifdef HELLO_HEX_X86
+    case HEX_BACKEND_SSSE3:
+        return &hex_kernel_ssse3;
+    case HEX_BACKEND_AVX2:
+        return &hex_kernel_avx2;
+#endif
+#ifdef __wasm_simd128__
+    case HEX_BACKEND_SIMD128:
+        return &hex_kernel_simd128;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+}
@@ -0,0 +1,28 @@
+#ifndef HELLO_HEX_SIMD_HPP
+#define HELLO_HEX_SIMD_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hex.hpp"
+
+namespace Hello {
+
+// Vector hex kernels. Each covers a prefix of its input in whole vector
+// blocks and returns how many bytes it handled; hex.cpp finishes the rest,
+// and any block holding a bad character, with the scalar table code, so
+// error positions are reported the same way on every backend.
+struct HexKernel {
+    // Encodes a prefix of in; returns the number of input bytes encoded.
+    size_t (*encode)(const uint8_t* in, size_t len, char* out);
+    // Decodes up to count output bytes, stopping before the first block that
+    // contains a non-hex character; returns the number of bytes decoded.
+    size_t (*decode)(const char* hex, size_t count, uint8_t* out);
+};
+
+// Kernel for the current hex backend, or nullptr for HEX_BACKEND_SCALAR.
+const HexKernel* hex_kernel();
+
+}
+
+#endif
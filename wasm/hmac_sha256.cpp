@@ -0,0 +1,223 @@
+#include "hmac_sha256.hpp"
+
+#include <string.h>
+
+#include <vector>
+
+#include "memzero.hpp"
+#include "sha256_multi.hpp"
+
+namespace Hello
+{
+
+#define HMAC_IPAD 0x36363636UL
+#define HMAC_OPAD 0x5c5c5c5cUL
+
+/* Bit length of a 32-byte message that follows one already absorbed block:
+ * the inner hash of an HMAC over a digest, and the outer hash of any HMAC. */
+#define HMAC_DIGEST_BLOCK_BITS ((SHA256_BLOCK_LENGTH + SHA256_DIGEST_LENGTH) * 8)
+
+/* PBKDF2 output blocks kept in flight at once. */
+#define PBKDF2_JOBS_MAX 64
+
+static inline uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void write_be32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t)(x >> 24);
+    p[1] = (uint8_t)(x >> 16);
+    p[2] = (uint8_t)(x >> 8);
+    p[3] = (uint8_t)x;
+}
+
+/* Lays out a block holding a 32-byte digest followed by its final padding.
+ * Words 8..15 never change, so loops only rewrite words 0..7. */
+static void hmac_digest_block(uint32_t block[16]) {
+    block[8] = 0x80000000UL;
+    for (int j = 9; j < 15; j++) {
+        block[j] = 0;
+    }
+    block[15] = HMAC_DIGEST_BLOCK_BITS;
+}
+
+/*** HMAC-SHA256 ******************************************************/
+void hmac_sha256_Init(HMAC_SHA256_CTX* hctx, const uint8_t* key, size_t keylen) {
+    uint8_t k[SHA256_BLOCK_LENGTH];
+    uint32_t pad[16];
+
+    memset(k, 0, sizeof(k));
+    if (keylen > SHA256_BLOCK_LENGTH) {
+        sha256_Raw(key, keylen, k);
+    } else if (keylen > 0) {
+        memcpy(k, key, keylen);
+    }
+
+    for (int j = 0; j < 16; j++) {
+        pad[j] = read_be32(k + j * 4) ^ HMAC_IPAD;
+    }
+    sha256_Transform(sha256_initial_hash_value, pad, hctx->inner);
+    for (int j = 0; j < 16; j++) {
+        pad[j] ^= HMAC_IPAD ^ HMAC_OPAD;
+    }
+    sha256_Transform(sha256_initial_hash_value, pad, hctx->outer);
+
+    memzero(k, sizeof(k));
+    memzero(pad, sizeof(pad));
+    hmac_sha256_Reset(hctx);
+}
+
+void hmac_sha256_Reset(HMAC_SHA256_CTX* hctx) {
+    memcpy(hctx->context.state, hctx->inner, sizeof(hctx->inner));
+    memzero(hctx->context.buffer, SHA256_BLOCK_LENGTH);
+    hctx->context.bitcount = SHA256_BLOCK_LENGTH * 8;
+}
+
+void hmac_sha256_Update(HMAC_SHA256_CTX* hctx, const uint8_t* msg, size_t len) {
+    sha256_Update(&hctx->context, msg, len);
+}
+
+void hmac_sha256_Final(HMAC_SHA256_CTX* hctx, uint8_t mac[SHA256_DIGEST_LENGTH]) {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    uint32_t block[16], state[8];
+
+    sha256_Final(&hctx->context, digest);
+    for (int j = 0; j < 8; j++) {
+        block[j] = read_be32(digest + j * 4);
+    }
+    hmac_digest_block(block);
+    sha256_Transform(hctx->outer, block, state);
+    for (int j = 0; j < 8; j++) {
+        write_be32(mac + j * 4, state[j]);
+    }
+
+    memzero(digest, sizeof(digest));
+    memzero(block, sizeof(block));
+    memzero(state, sizeof(state));
+    hmac_sha256_Reset(hctx);
+}
+
+void hmac_sha256_Clear(HMAC_SHA256_CTX* hctx) {
+    memzero(hctx, sizeof(*hctx));
+}
+
+void hmac_sha256(const uint8_t* key, size_t keylen, const uint8_t* msg, size_t msglen, uint8_t mac[SHA256_DIGEST_LENGTH]) {
+    HMAC_SHA256_CTX hctx;
+    hmac_sha256_Init(&hctx, key, keylen);
+    hmac_sha256_Update(&hctx, msg, msglen);
+    hmac_sha256_Final(&hctx, mac);
+    hmac_sha256_Clear(&hctx);
+}
+
+/*** PBKDF2-HMAC-SHA256 ***********************************************/
+/*
+ * One job per 32-byte output block T_i. All jobs iterate in lockstep:
+ *
+ *   inner[j] = F(istate[j], U[j] || pad)
+ *   U[j]     = F(ostate[j], inner[j] || pad)
+ *   T[j]    ^= U[j]
+ *
+ * with U kept in words 0..7 of the pre-padded blocks between rounds.
+ */
+typedef struct _PBKDF2_JOBS {
+    uint32_t (*istate)[8];
+    uint32_t (*ostate)[8];
+    uint32_t (*ublock)[16];
+    uint32_t (*iblock)[16];
+    uint32_t (*mid)[8];
+    uint32_t (*t)[8];
+    uint8_t* out[PBKDF2_JOBS_MAX];
+    size_t outlen[PBKDF2_JOBS_MAX];
+    size_t count;
+} PBKDF2_JOBS;
+
+static void pbkdf2_add_job(PBKDF2_JOBS* jobs, HMAC_SHA256_CTX* hctx, const uint8_t* salt, size_t saltlen, uint32_t index, uint8_t* out,
+                           size_t outlen) {
+    size_t j = jobs->count++;
+    uint8_t be_index[4], u[SHA256_DIGEST_LENGTH];
+
+    write_be32(be_index, index);
+    hmac_sha256_Reset(hctx);
+    hmac_sha256_Update(hctx, salt, saltlen);
+    hmac_sha256_Update(hctx, be_index, sizeof(be_index));
+    hmac_sha256_Final(hctx, u);
+
+    memcpy(jobs->istate[j], hctx->inner, sizeof(hctx->inner));
+    memcpy(jobs->ostate[j], hctx->outer, sizeof(hctx->outer));
+    for (int k = 0; k < 8; k++) {
+        jobs->ublock[j][k] = jobs->t[j][k] = read_be32(u + k * 4);
+    }
+    hmac_digest_block(jobs->ublock[j]);
+    hmac_digest_block(jobs->iblock[j]);
+    jobs->out[j] = out;
+    jobs->outlen[j] = outlen;
+    memzero(u, sizeof(u));
+}
+
+static void pbkdf2_run_jobs(PBKDF2_JOBS* jobs, uint32_t iterations) {
+    size_t n = jobs->count;
+    for (uint32_t i = 1; i < iterations; i++) {
+        sha256_TransformMany(jobs->istate, jobs->ublock, jobs->mid, n);
+        for (size_t j = 0; j < n; j++) {
+            memcpy(jobs->iblock[j], jobs->mid[j], sizeof(jobs->mid[j]));
+        }
+        sha256_TransformMany(jobs->ostate, jobs->iblock, jobs->mid, n);
+        for (size_t j = 0; j < n; j++) {
+            for (int k = 0; k < 8; k++) {
+                jobs->ublock[j][k] = jobs->mid[j][k];
+                jobs->t[j][k] ^= jobs->mid[j][k];
+            }
+        }
+    }
+
+    uint8_t block[SHA256_DIGEST_LENGTH];
+    for (size_t j = 0; j < n; j++) {
+        for (int k = 0; k < 8; k++) {
+            write_be32(block + k * 4, jobs->t[j][k]);
+        }
+        memcpy(jobs->out[j], block, jobs->outlen[j]);
+    }
+    memzero(block, sizeof(block));
+    jobs->count = 0;
+}
+
+void pbkdf2_hmac_sha256_batch(const uint8_t* const* passes, const size_t* passlens, size_t n, const uint8_t* salt, size_t saltlen,
+                              uint32_t iterations, uint8_t* keys, size_t keylen) {
+    /* Words per job: istate, ostate, mid, t (8 each) and two blocks (16 each). */
+    std::vector<uint32_t> storage(PBKDF2_JOBS_MAX * (4 * 8 + 2 * 16));
+    PBKDF2_JOBS jobs;
+    uint32_t* words = storage.data();
+    jobs.istate = (uint32_t (*)[8])words;
+    jobs.ostate = (uint32_t (*)[8])(words += PBKDF2_JOBS_MAX * 8);
+    jobs.mid = (uint32_t (*)[8])(words += PBKDF2_JOBS_MAX * 8);
+    jobs.t = (uint32_t (*)[8])(words += PBKDF2_JOBS_MAX * 8);
+    jobs.ublock = (uint32_t (*)[16])(words += PBKDF2_JOBS_MAX * 8);
+    jobs.iblock = (uint32_t (*)[16])(words += PBKDF2_JOBS_MAX * 16);
+    jobs.count = 0;
+
+    HMAC_SHA256_CTX hctx;
+    for (size_t p = 0; p < n; p++) {
+        hmac_sha256_Init(&hctx, passes[p], passlens[p]);
+        uint8_t* key = keys + p * keylen;
+        for (size_t offset = 0; offset < keylen; offset += SHA256_DIGEST_LENGTH) {
+            size_t outlen = (keylen - offset < SHA256_DIGEST_LENGTH) ? keylen - offset : SHA256_DIGEST_LENGTH;
+            pbkdf2_add_job(&jobs, &hctx, salt, saltlen, (uint32_t)(offset / SHA256_DIGEST_LENGTH + 1), key + offset, outlen);
+            if (jobs.count == PBKDF2_JOBS_MAX) {
+                pbkdf2_run_jobs(&jobs, iterations);
+            }
+        }
+    }
+    if (jobs.count > 0) {
+        pbkdf2_run_jobs(&jobs, iterations);
+    }
+
+    hmac_sha256_Clear(&hctx);
+    memzero(storage.data(), storage.size() * sizeof(uint32_t));
+}
+
+void pbkdf2_hmac_sha256(const uint8_t* pass, size_t passlen, const uint8_t* salt, size_t saltlen, uint32_t iterations,
+                        uint8_t* key, size_t keylen) {
+    pbkdf2_hmac_sha256_batch(&pass, &passlen, 1, salt, saltlen, iterations, key, keylen);
+}
+
+} // namespace Hello
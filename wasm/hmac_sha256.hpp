@@ -0,0 +1,53 @@
+#ifndef HELLO_HMAC_SHA_256_HPP
+#define HELLO_HMAC_SHA_256_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+/*** HMAC-SHA256 ******************************************************/
+/*
+ * A keyed context absorbs key ^ ipad and key ^ opad once, in
+ * hmac_sha256_Init, and keeps both midstates. Every later message under the
+ * same key starts from the cached inner state, and the outer hash is a single
+ * compression of the inner digest from the cached outer state.
+ */
+typedef struct _HMAC_SHA256_CTX {
+    uint32_t inner[8]; /* State after the key ^ ipad block */
+    uint32_t outer[8]; /* State after the key ^ opad block */
+    SHA256_CTX context;
+} HMAC_SHA256_CTX;
+
+void hmac_sha256_Init(HMAC_SHA256_CTX*, const uint8_t* key, size_t keylen);
+// Starts a new message under the same key.
+void hmac_sha256_Reset(HMAC_SHA256_CTX*);
+void hmac_sha256_Update(HMAC_SHA256_CTX*, const uint8_t*, size_t);
+// Writes the MAC and resets the context for the next message.
+void hmac_sha256_Final(HMAC_SHA256_CTX*, uint8_t[SHA256_DIGEST_LENGTH]);
+// Wipes the key-derived state.
+void hmac_sha256_Clear(HMAC_SHA256_CTX*);
+void hmac_sha256(const uint8_t* key, size_t keylen, const uint8_t* msg, size_t msglen, uint8_t mac[SHA256_DIGEST_LENGTH]);
+
+/*** PBKDF2-HMAC-SHA256 ***********************************************/
+/*
+ * Each iteration is exactly two compressions (inner and outer) on
+ * pre-padded host-order blocks; nothing goes through Update/Final. Output
+ * blocks are independent, so a key longer than 32 bytes, or a batch of
+ * passwords, is derived with every block on its own SIMD lane through
+ * sha256_TransformMany. An iteration count of 0 is treated as 1.
+ */
+void pbkdf2_hmac_sha256(const uint8_t* pass, size_t passlen, const uint8_t* salt, size_t saltlen, uint32_t iterations,
+                        uint8_t* key, size_t keylen);
+
+// Derives keylen bytes for each of n passwords with the same salt into
+// keys[i * keylen .. (i + 1) * keylen).
+void pbkdf2_hmac_sha256_batch(const uint8_t* const* passes, const size_t* passlens, size_t n, const uint8_t* salt, size_t saltlen,
+                              uint32_t iterations, uint8_t* keys, size_t keylen);
+
+} // namespace Hello
+
+#endif
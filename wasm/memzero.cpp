@@ -57,19 +57,16 @@ void memzero(void *const pnt, const size_t len) {
 #elif defined(HAVE_MEMSET_S)
   memset_s(pnt, (rsize_t)len, 0, (rsize_t)len);
 #elif defined(HAVE_EXPLICIT_BZERO)
-  bzero(pnt, len);
+  explicit_bzero(pnt, len);
 #elif defined(HAVE_EXPLICIT_MEMSET)
   explicit_memset(pnt, 0, len);
 #else
-  volatile unsigned char *volatile pnt_ = (volatile unsigned char *volatile)pnt;
-  size_t i = (size_t)0U;
-
-  while (i < len) {
-    pnt_[i++] = 0U;
-  }
+  /* A plain memset (memory.fill on wasm) rather than a volatile byte loop,
+   * so bulk wipes of arena blocks and pool slabs run at memset speed. */
+  memset(pnt, 0, len);
 
   /* Memory barrier that scares the compiler away from optimizing out
-   * the above loop.
+   * the above memset.
    *
    * Quoting Adam Langley <agl@google.com> in commit
    * ad1907fe73334d6c696c8539646c21b11178f20f of BoringSSL (ISC License):
@@ -82,7 +79,7 @@ void memzero(void *const pnt, const size_t len) {
    *    Elimination (Still) Considered Harmful" by Yang et al. (USENIX Security
    *    2017) for more background.
    */
-  __asm__ __volatile__("" : : "r"(pnt_) : "memory");
+  __asm__ __volatile__("" : : "r"(pnt) : "memory");
 #endif
 }
 
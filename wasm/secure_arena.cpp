@@ -0,0 +1,146 @@
+#include "secure_arena.hpp"
+
+#include <string.h>
+
+#if defined(__unix__) && !defined(__EMSCRIPTEN__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define HELLO_HAVE_MLOCK 1
+#endif
+
+#include "memzero.hpp"
+#include "stats.hpp"
+
+namespace Hello
+{
+
+static size_t round_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+SecureArena::SecureArena(size_t slot_size, size_t slots_per_slab, bool lock)
+    : slabs_(nullptr), free_(nullptr), slot_size_(round_up(slot_size < sizeof(Slot) ? sizeof(Slot) : slot_size, 16)),
+      slots_per_slab_(slots_per_slab ? slots_per_slab : 1), in_use_(0), lock_(lock) {
+}
+
+SecureArena::~SecureArena() {
+    while(slabs_) {
+        Slab* next = slabs_->next;
+        memzero(slabs_->slots, slabs_->bytes);
+#ifdef HELLO_HAVE_MLOCK
+        if(slabs_->locked) {
+            munlock(slabs_->slots, slabs_->bytes);
+        }
+#endif
+        stats_free(slabs_);
+        slabs_ = next;
+    }
+}
+
+bool SecureArena::new_slab() {
+    size_t align = 16;
+    size_t bytes = slot_size_ * slots_per_slab_;
+#ifdef HELLO_HAVE_MLOCK
+    if(lock_) {
+        // Page-aligned and page-sized, so no other allocation shares a
+        // locked page and munlock cannot unlock someone else's memory.
+        align = (size_t)sysconf(_SC_PAGESIZE);
+        bytes = round_up(bytes, align);
+    }
+#endif
+    auto slab = (Slab*)stats_malloc(sizeof(Slab) + align + bytes);
+    if(!slab) {
+        return false;
+    }
+    slab->slots = (uint8_t*)round_up((uintptr_t)(slab + 1), align);
+    slab->bytes = bytes;
+    slab->locked = false;
+#ifdef HELLO_HAVE_MLOCK
+    slab->locked = lock_ && mlock(slab->slots, bytes) == 0;
+#endif
+    memset(slab->slots, 0, bytes);
+    slab->next = slabs_;
+    slabs_ = slab;
+
+    for(size_t i = bytes / slot_size_; i-- > 0;) {
+        auto slot = (Slot*)(slab->slots + i * slot_size_);
+        slot->next = free_;
+        free_ = slot;
+    }
+    return true;
+}
+
+void* SecureArena::alloc() {
+    if(!free_ && !new_slab()) {
+        return nullptr;
+    }
+    Slot* slot = free_;
+    free_ = slot->next;
+    slot->next = nullptr;
+    in_use_++;
+    return slot;
+}
+
+void SecureArena::release(void* p) {
+    if(!p) {
+        return;
+    }
+    memzero(p, slot_size_);
+    auto slot = (Slot*)p;
+    slot->next = free_;
+    free_ = slot;
+    in_use_--;
+}
+
+// Slabs of about this many bytes; the larger classes get one slot per slab.
+static const size_t SLAB_BYTES = 16 * 1024;
+
+static size_t size_class(size_t size) {
+    size_t c = 0;
+    while((SecurePool::MIN_SIZE << c) < size) {
+        c++;
+    }
+    return c;
+}
+
+SecurePool::SecurePool(bool lock) : lock_(lock) {
+    for(auto& arena : classes_) {
+        arena = nullptr;
+    }
+}
+
+SecurePool::~SecurePool() {
+    for(auto arena : classes_) {
+        delete arena;
+    }
+}
+
+void* SecurePool::alloc(size_t size) {
+    if(size > MAX_SIZE) {
+        void* p = stats_malloc(size);
+        if(p) {
+            memset(p, 0, size);
+        }
+        return p;
+    }
+    size_t c = size_class(size);
+    if(!classes_[c]) {
+        size_t slot = MIN_SIZE << c;
+        classes_[c] = new SecureArena(slot, slot < SLAB_BYTES ? SLAB_BYTES / slot : 1, lock_);
+    }
+    return classes_[c]->alloc();
+}
+
+void SecurePool::release(void* p, size_t size) {
+    if(!p) {
+        return;
+    }
+    if(size > MAX_SIZE) {
+        memzero(p, size);
+        stats_free(p);
+        return;
+    }
+    classes_[size_class(size)]->release(p);
+}
+
+} // namespace Hello
@@ -0,0 +1,93 @@
+#ifndef HELLO_SECURE_ARENA_HPP
+#define HELLO_SECURE_ARENA_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Hello
+{
+
+// Fixed-size slot allocator for key material and hash contexts. Slots are
+// carved out of slabs of slots_per_slab and go back on a free list when
+// released, so a steady workload stops calling malloc after warm-up.
+//
+// Every released slot is wiped with one memzero call before it can be handed
+// out again, and the destructor wipes each slab with one memzero call before
+// returning it to the system. With lock set, slabs are page-aligned and
+// mlock()ed so secrets are never swapped out; this is best effort (it is
+// skipped on wasm, and a failing mlock, e.g. past RLIMIT_MEMLOCK, is not an
+// error). Not thread-safe.
+class SecureArena {
+public:
+    explicit SecureArena(size_t slot_size, size_t slots_per_slab = 64, bool lock = false);
+    ~SecureArena();
+
+    SecureArena(const SecureArena&) = delete;
+    SecureArena& operator=(const SecureArena&) = delete;
+
+    // Returns a 16-byte aligned slot of slot_size() bytes, or nullptr if the
+    // system allocator is out of memory. The slot is zeroed.
+    void* alloc();
+
+    // Wipes p and makes it available to alloc() again. p must come from this
+    // arena; nullptr is ignored.
+    void release(void* p);
+
+    size_t slot_size() const { return slot_size_; }
+
+    // Slots handed out and not yet released.
+    size_t in_use() const { return in_use_; }
+
+private:
+    struct Slab {
+        Slab* next;
+        uint8_t* slots;
+        size_t bytes;
+        bool locked;
+    };
+    struct Slot {
+        Slot* next;
+    };
+
+    bool new_slab();
+
+    Slab* slabs_;
+    Slot* free_;
+    size_t slot_size_;
+    size_t slots_per_slab_;
+    size_t in_use_;
+    bool lock_;
+};
+
+// Size-classed front end over SecureArena for buffers of any size: requests
+// are rounded up to a power of two between MIN_SIZE and MAX_SIZE and served
+// by the arena of that class. Larger requests go straight to the system
+// allocator and are wiped before being freed. Not thread-safe.
+class SecurePool {
+public:
+    static constexpr size_t MIN_SIZE = 64;
+    static constexpr size_t MAX_SIZE = 128 * 1024;
+
+    explicit SecurePool(bool lock = false);
+    ~SecurePool();
+
+    SecurePool(const SecurePool&) = delete;
+    SecurePool& operator=(const SecurePool&) = delete;
+
+    // Returns size zeroed bytes, aligned at least as well as malloc, or
+    // nullptr if the system allocator is out of memory.
+    void* alloc(size_t size);
+
+    // Wipes and releases p, which alloc(size) returned; size must match.
+    void release(void* p, size_t size);
+
+private:
+    static constexpr size_t CLASSES = 12; // 64 B .. 128 KiB
+
+    SecureArena* classes_[CLASSES];
+    bool lock_;
+};
+
+} // namespace Hello
+
+#endif
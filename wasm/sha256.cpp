@@ -31,8 +31,16 @@
 #include "sha256.hpp"
 
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+#include "cpu.hpp"
 #include "memzero.hpp"
 
 namespace Hello
@@ -79,6 +87,23 @@ typedef uint32_t sha2_word32; /* Exactly 4 bytes */
 #define SHA256_SHORT_BLOCK_LENGTH (SHA256_BLOCK_LENGTH - 8)
 
 #define MEMCPY_BCOPY(d, s, l) memcpy((d), (s), (l))
+/* Plain fill for padding and initialization; memzero is kept for wiping: */
+#define MEMSET_BZERO(p, l) memset((p), 0, (l))
+
+/* Loads a big-endian word from a possibly unaligned pointer (one bswap or
+ * movbe on little-endian targets). */
+static inline sha2_word32 sha256_LoadBE32(const sha2_byte* p) {
+    sha2_word32 w;
+    MEMCPY_BCOPY(&w, p, sizeof(w));
+#if BYTE_ORDER == LITTLE_ENDIAN
+#if defined(__GNUC__)
+    w = __builtin_bswap32(w);
+#else
+    REVERSE32(w, w);
+#endif
+#endif
+    return w;
+}
 
 /*** THE SIX LOGICAL FUNCTIONS ****************************************/
 /*
@@ -122,7 +147,7 @@ typedef uint32_t sha2_word32; /* Exactly 4 bytes */
 /*** SHA-XYZ INITIAL HASH VALUES AND CONSTANTS ************************/
 
 /* Hash constant words K for SHA-256: */
-static const sha2_word32 K256[64] = {0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL, 0x243185beUL,
+const sha2_word32 sha256_K256[64] = {0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL, 0x59f111f1UL, 0x923f82a4UL, 0xab1c5ed5UL, 0xd807aa98UL, 0x12835b01UL, 0x243185beUL,
                                      0x550c7dc3UL, 0x72be5d74UL, 0x80deb1feUL, 0x9bdc06a7UL, 0xc19bf174UL, 0xe49b69c1UL, 0xefbe4786UL, 0x0fc19dc6UL, 0x240ca1ccUL, 0x2de92c6fUL, 0x4a7484aaUL,
                                      0x5cb0a9dcUL, 0x76f988daUL, 0x983e5152UL, 0xa831c66dUL, 0xb00327c8UL, 0xbf597fc7UL, 0xc6e00bf3UL, 0xd5a79147UL, 0x06ca6351UL, 0x14292967UL, 0x27b70a85UL,
                                      0x2e1b2138UL, 0x4d2c6dfcUL, 0x53380d13UL, 0x650a7354UL, 0x766a0abbUL, 0x81c2c92eUL, 0x92722c85UL, 0xa2bfe8a1UL, 0xa81a664bUL, 0xc24b8b70UL, 0xc76c51a3UL,
@@ -144,13 +169,92 @@ void sha256_Init(SHA256_CTX* context) {
         return;
     }
     MEMCPY_BCOPY(context->state, sha256_initial_hash_value, SHA256_DIGEST_LENGTH);
-    memzero(context->buffer, SHA256_BLOCK_LENGTH);
+    MEMSET_BZERO(context->buffer, SHA256_BLOCK_LENGTH);
     context->bitcount = 0;
 }
 
-void sha256_Transform(const sha2_word32* state_in, const sha2_word32* data, sha2_word32* state_out) {
+#ifdef __wasm_simd128__
+/*
+ * SIMD128 build: the message schedule is expanded four words at a time
+ * before the rounds start. W[t+2] and W[t+3] depend on W[t] and W[t+1] of
+ * the same vector, so sigma1 is applied in two halves.
+ */
+#define ROTR32_V128(b, x) wasm_v128_or(wasm_u32x4_shr((x), (b)), wasm_i32x4_shl((x), 32 - (b)))
+#define sigma0_v128(x) wasm_v128_xor(wasm_v128_xor(ROTR32_V128(7, (x)), ROTR32_V128(18, (x))), wasm_u32x4_shr((x), 3))
+#define sigma1_v128(x) wasm_v128_xor(wasm_v128_xor(ROTR32_V128(17, (x)), ROTR32_V128(19, (x))), wasm_u32x4_shr((x), 10))
+
+static void sha256_Expand_simd128(sha2_word32 W256[64]) {
+    const v128_t zero = wasm_i32x4_splat(0);
+    for (int j = 16; j < 64; j += 4) {
+        v128_t w = wasm_i32x4_add(wasm_v128_load(&W256[j - 16]), sigma0_v128(wasm_v128_load(&W256[j - 15])));
+        w = wasm_i32x4_add(w, wasm_v128_load(&W256[j - 7]));
+        w = wasm_i32x4_add(w, sigma1_v128(wasm_v128_load64_zero(&W256[j - 2])));
+        w = wasm_i32x4_add(w, sigma1_v128(wasm_i32x4_shuffle(zero, w, 0, 1, 4, 5)));
+        wasm_v128_store(&W256[j], w);
+    }
+    for (int j = 0; j < 64; j += 4) {
+        wasm_v128_store(&W256[j], wasm_i32x4_add(wasm_v128_load(&W256[j]), wasm_v128_load(&sha256_K256[j])));
+    }
+}
+
+static inline __attribute__((always_inline)) void sha256_Compress(const sha2_word32* state_in, const void* data, int big_endian_bytes,
+                                                                   sha2_word32* state_out) {
+    sha2_word32 a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0;
+    sha2_word32 T1 = 0, T2 = 0, W256[64];
+    int j = 0;
+
+    if (big_endian_bytes) {
+        for (j = 0; j < 16; j += 4) {
+            v128_t w = wasm_v128_load((const sha2_byte*)data + j * 4);
+            wasm_v128_store(&W256[j], wasm_i8x16_shuffle(w, w, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+        }
+    } else {
+        MEMCPY_BCOPY(W256, data, SHA256_BLOCK_LENGTH);
+    }
+    sha256_Expand_simd128(W256);
+
+    a = state_in[0];
+    b = state_in[1];
+    c = state_in[2];
+    d = state_in[3];
+    e = state_in[4];
+    f = state_in[5];
+    g = state_in[6];
+    h = state_in[7];
+
+    for (j = 0; j < 64; j++) {
+        /* W256 already carries the round constant */
+        T1 = h + Sigma1_256(e) + Ch(e, f, g) + W256[j];
+        T2 = Sigma0_256(a) + Maj(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + T1;
+        d = c;
+        c = b;
+        b = a;
+        a = T1 + T2;
+    }
+
+    state_out[0] = state_in[0] + a;
+    state_out[1] = state_in[1] + b;
+    state_out[2] = state_in[2] + c;
+    state_out[3] = state_in[3] + d;
+    state_out[4] = state_in[4] + e;
+    state_out[5] = state_in[5] + f;
+    state_out[6] = state_in[6] + g;
+    state_out[7] = state_in[7] + h;
+
+    /* Clean up */
+    a = b = c = d = e = f = g = h = T1 = T2 = 0;
+}
+#else
+static inline __attribute__((always_inline)) void sha256_Compress(const sha2_word32* state_in, const void* data, int big_endian_bytes,
+                                                                   sha2_word32* state_out) {
     sha2_word32 a = 0, b = 0, c = 0, d = 0, e = 0, f = 0, g = 0, h = 0;
     sha2_word32 T1 = 0, T2 = 0, W256[16] = {0};
+    const sha2_word32* words = (const sha2_word32*)data;
+    const sha2_byte* bytes = (const sha2_byte*)data;
     int j = 0;
 
     /* Initialize registers with the prev. intermediate value */
@@ -166,7 +270,8 @@ void sha256_Transform(const sha2_word32* state_in, const sha2_word32* data, sha2
     j = 0;
     do {
         /* Apply the SHA-256 compression function to update a..h with copy */
-        T1 = h + Sigma1_256(e) + Ch(e, f, g) + K256[j] + (W256[j] = *data++);
+        W256[j] = big_endian_bytes ? sha256_LoadBE32(bytes + j * 4) : words[j];
+        T1 = h + Sigma1_256(e) + Ch(e, f, g) + sha256_K256[j] + W256[j];
         T2 = Sigma0_256(a) + Maj(a, b, c);
         h = g;
         g = f;
@@ -189,7 +294,7 @@ void sha256_Transform(const sha2_word32* state_in, const sha2_word32* data, sha2
         s1 = sigma1_256(s1);
 
         /* Apply the SHA-256 compression function to update a..h */
-        T1 = h + Sigma1_256(e) + Ch(e, f, g) + K256[j] + (W256[j & 0x0f] += s1 + W256[(j + 9) & 0x0f] + s0);
+        T1 = h + Sigma1_256(e) + Ch(e, f, g) + sha256_K256[j] + (W256[j & 0x0f] += s1 + W256[(j + 9) & 0x0f] + s0);
         T2 = Sigma0_256(a) + Maj(a, b, c);
         h = g;
         g = f;
@@ -216,6 +321,136 @@ void sha256_Transform(const sha2_word32* state_in, const sha2_word32* data, sha2
     /* Clean up */
     a = b = c = d = e = f = g = h = T1 = T2 = 0;
 }
+#endif /* __wasm_simd128__ */
+
+void sha256_Transform_portable(const sha2_word32* state_in, const sha2_word32* data, sha2_word32* state_out) {
+    sha256_Compress(state_in, data, 0, state_out);
+}
+
+void sha256_Transform_blocks_portable(sha2_word32* state, const sha2_byte* data, size_t nblocks) {
+    for (size_t i = 0; i < nblocks; i++) {
+        sha256_Compress(state, data + i * SHA256_BLOCK_LENGTH, 1, state);
+    }
+}
+
+/*** BACKEND DISPATCH *************************************************/
+typedef void (*sha256_transform_fn)(const sha2_word32*, const sha2_word32*, sha2_word32*);
+typedef void (*sha256_blocks_fn)(sha2_word32*, const sha2_byte*, size_t);
+
+static void sha256_Transform_resolve(const sha2_word32* state_in, const sha2_word32* data, sha2_word32* state_out);
+static void sha256_Transform_blocks_resolve(sha2_word32* state, const sha2_byte* data, size_t nblocks);
+
+/*
+ * Both start out pointing at a resolver so that callers running before or
+ * during static initialization still get a working transform.
+ */
+static std::atomic<sha256_transform_fn> sha256_transform_impl(sha256_Transform_resolve);
+static std::atomic<sha256_blocks_fn> sha256_blocks_impl(sha256_Transform_blocks_resolve);
+static std::atomic<int> sha256_backend_current(-1);
+
+static sha256_transform_fn sha256_backend_fn(SHA256_BACKEND backend) {
+    switch (backend) {
+    case SHA256_BACKEND_SHA_NI:
+        return sha256_Transform_shani;
+    case SHA256_BACKEND_ARMV8:
+        return sha256_Transform_armv8;
+    default:
+        return sha256_Transform_portable;
+    }
+}
+
+static sha256_blocks_fn sha256_backend_blocks_fn(SHA256_BACKEND backend) {
+    switch (backend) {
+    case SHA256_BACKEND_SHA_NI:
+        return sha256_Transform_blocks_shani;
+    case SHA256_BACKEND_ARMV8:
+        return sha256_Transform_blocks_armv8;
+    default:
+        return sha256_Transform_blocks_portable;
+    }
+}
+
+bool sha256_BackendSupported(SHA256_BACKEND backend) {
+    switch (backend) {
+    case SHA256_BACKEND_PORTABLE:
+        return true;
+    case SHA256_BACKEND_SHA_NI:
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        return cpu_features().sha_ni;
+#else
+        return false;
+#endif
+    case SHA256_BACKEND_ARMV8:
+#if defined(__GNUC__) && defined(__aarch64__)
+        return cpu_features().arm_sha2;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+bool sha256_SetBackend(SHA256_BACKEND backend) {
+    if (!sha256_BackendSupported(backend)) {
+        return false;
+    }
+    sha256_backend_current.store(backend, std::memory_order_relaxed);
+    sha256_transform_impl.store(sha256_backend_fn(backend), std::memory_order_relaxed);
+    sha256_blocks_impl.store(sha256_backend_blocks_fn(backend), std::memory_order_relaxed);
+    return true;
+}
+
+static SHA256_BACKEND sha256_backend_select(void) {
+    const char* portable = getenv("HELLO_SHA256_PORTABLE");
+    if (portable != NULL && *portable != '\0' && strcmp(portable, "0") != 0) {
+        return SHA256_BACKEND_PORTABLE;
+    }
+    if (sha256_BackendSupported(SHA256_BACKEND_SHA_NI)) {
+        return SHA256_BACKEND_SHA_NI;
+    }
+    if (sha256_BackendSupported(SHA256_BACKEND_ARMV8)) {
+        return SHA256_BACKEND_ARMV8;
+    }
+    return SHA256_BACKEND_PORTABLE;
+}
+
+SHA256_BACKEND sha256_Backend(void) {
+    int backend = sha256_backend_current.load(std::memory_order_relaxed);
+    if (backend < 0) {
+        /* Nothing has been hashed yet; report what the first call will pick. */
+        return sha256_backend_select();
+    }
+    return (SHA256_BACKEND)backend;
+}
+
+/* Picks the backend on first use and returns it, or the one an explicit
+ * sha256_SetBackend that raced ahead of us chose. */
+static SHA256_BACKEND sha256_backend_resolve(void) {
+    int unset = -1;
+    SHA256_BACKEND backend = sha256_backend_select();
+    if (sha256_backend_current.compare_exchange_strong(unset, backend, std::memory_order_relaxed)) {
+        sha256_transform_impl.store(sha256_backend_fn(backend), std::memory_order_relaxed);
+        sha256_blocks_impl.store(sha256_backend_blocks_fn(backend), std::memory_order_relaxed);
+        return backend;
+    }
+    return (SHA256_BACKEND)unset;
+}
+
+static void sha256_Transform_resolve(const sha2_word32* state_in, const sha2_word32* data, sha2_word32* state_out) {
+    sha256_backend_fn(sha256_backend_resolve())(state_in, data, state_out);
+}
+
+static void sha256_Transform_blocks_resolve(sha2_word32* state, const sha2_byte* data, size_t nblocks) {
+    sha256_backend_blocks_fn(sha256_backend_resolve())(state, data, nblocks);
+}
+
+void sha256_Transform(const sha2_word32* state_in, const sha2_word32* data, sha2_word32* state_out) {
+    sha256_transform_impl.load(std::memory_order_relaxed)(state_in, data, state_out);
+}
+
+void sha256_Transform_blocks(sha2_word32* state, const sha2_byte* data, size_t nblocks) {
+    sha256_blocks_impl.load(std::memory_order_relaxed)(state, data, nblocks);
+}
 
 void sha256_Update(SHA256_CTX* context, const sha2_byte* data, size_t len) {
     unsigned int freespace = 0, usedspace = 0;
@@ -236,13 +471,7 @@ void sha256_Update(SHA256_CTX* context, const sha2_byte* data, size_t len) {
             context->bitcount += freespace << 3;
             len -= freespace;
             data += freespace;
-#if BYTE_ORDER == LITTLE_ENDIAN
-            /* Convert TO host byte order */
-            for (int j = 0; j < 16; j++) {
-                REVERSE32(context->buffer[j], context->buffer[j]);
-            }
-#endif
-            sha256_Transform(context->state, context->buffer, context->state);
+            sha256_Transform_blocks(context->state, (const sha2_byte*)context->buffer, 1);
         } else {
             /* The buffer is not yet full */
             MEMCPY_BCOPY(((uint8_t*)context->buffer) + usedspace, data, len);
@@ -252,19 +481,14 @@ void sha256_Update(SHA256_CTX* context, const sha2_byte* data, size_t len) {
             return;
         }
     }
-    while (len >= SHA256_BLOCK_LENGTH) {
-        /* Process as many complete blocks as we can */
-        MEMCPY_BCOPY(context->buffer, data, SHA256_BLOCK_LENGTH);
-#if BYTE_ORDER == LITTLE_ENDIAN
-        /* Convert TO host byte order */
-        for (int j = 0; j < 16; j++) {
-            REVERSE32(context->buffer[j], context->buffer[j]);
-        }
-#endif
-        sha256_Transform(context->state, context->buffer, context->state);
-        context->bitcount += SHA256_BLOCK_LENGTH << 3;
-        len -= SHA256_BLOCK_LENGTH;
-        data += SHA256_BLOCK_LENGTH;
+    if (len >= SHA256_BLOCK_LENGTH) {
+        /* Process as many complete blocks as we can, straight from the
+         * caller's buffer */
+        size_t nblocks = len / SHA256_BLOCK_LENGTH;
+        sha256_Transform_blocks(context->state, data, nblocks);
+        context->bitcount += (uint64_t)nblocks * SHA256_BLOCK_LENGTH << 3;
+        len -= nblocks * SHA256_BLOCK_LENGTH;
+        data += nblocks * SHA256_BLOCK_LENGTH;
     }
     if (len > 0) {
         /* There's left-overs, so save 'em */
@@ -285,7 +509,7 @@ void sha256_Final(SHA256_CTX* context, sha2_byte digest[]) {
         ((uint8_t*)context->buffer)[usedspace++] = 0x80;
 
         if (usedspace > SHA256_SHORT_BLOCK_LENGTH) {
-            memzero(((uint8_t*)context->buffer) + usedspace, SHA256_BLOCK_LENGTH - usedspace);
+            MEMSET_BZERO(((uint8_t*)context->buffer) + usedspace, SHA256_BLOCK_LENGTH - usedspace);
 
 #if BYTE_ORDER == LITTLE_ENDIAN
             /* Convert TO host byte order */
@@ -300,7 +524,7 @@ void sha256_Final(SHA256_CTX* context, sha2_byte digest[]) {
             usedspace = 0;
         }
         /* Set-up for the last transform: */
-        memzero(((uint8_t*)context->buffer) + usedspace, SHA256_SHORT_BLOCK_LENGTH - usedspace);
+        MEMSET_BZERO(((uint8_t*)context->buffer) + usedspace, SHA256_SHORT_BLOCK_LENGTH - usedspace);
 
 #if BYTE_ORDER == LITTLE_ENDIAN
         /* Convert TO host byte order */
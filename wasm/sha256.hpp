@@ -69,8 +69,39 @@ typedef struct _SHA256_CTX {
 #endif /* BYTE_ORDER == LITTLE_ENDIAN */
 
 extern const uint32_t sha256_initial_hash_value[8];
+extern const uint32_t sha256_K256[64];
+
+/*** COMPRESSION BACKENDS *********************************************/
+/*
+ * sha256_Transform runs on the fastest backend the CPU supports, picked once
+ * on first use from the CPUID/HWCAP probe in cpu.hpp. Setting the
+ * HELLO_SHA256_PORTABLE environment variable, or calling sha256_SetBackend,
+ * pins it to the portable C rounds so both paths can be checked against the
+ * same known-answer vectors on one machine.
+ */
+typedef enum _SHA256_BACKEND {
+    SHA256_BACKEND_PORTABLE = 0,
+    SHA256_BACKEND_SHA_NI = 1,
+    SHA256_BACKEND_ARMV8 = 2,
+} SHA256_BACKEND;
+
+SHA256_BACKEND sha256_Backend(void);
+bool sha256_BackendSupported(SHA256_BACKEND);
+bool sha256_SetBackend(SHA256_BACKEND);
 
 void sha256_Transform(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out);
+void sha256_Transform_portable(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out);
+void sha256_Transform_shani(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out);
+void sha256_Transform_armv8(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out);
+
+// Absorbs nblocks contiguous 64-byte blocks into state, loading the
+// big-endian message words straight from data (any alignment) and keeping
+// the state in registers between blocks. sha256_Update uses this for every
+// full block.
+void sha256_Transform_blocks(uint32_t state[8], const uint8_t* data, size_t nblocks);
+void sha256_Transform_blocks_portable(uint32_t state[8], const uint8_t* data, size_t nblocks);
+void sha256_Transform_blocks_shani(uint32_t state[8], const uint8_t* data, size_t nblocks);
+void sha256_Transform_blocks_armv8(uint32_t state[8], const uint8_t* data, size_t nblocks);
 void sha256_Init(SHA256_CTX*);
 void sha256_Update(SHA256_CTX*, const uint8_t*, size_t);
 void sha256_Final(SHA256_CTX*, uint8_t[SHA256_DIGEST_LENGTH]);
@@ -0,0 +1,193 @@
+#include "sha256_cdc.hpp"
+
+#include <string.h>
+
+#include <memory>
+
+#include "thread_pool.hpp"
+
+namespace Hello
+{
+
+/* Slice of update() input appended to the tail before cutting, so a huge
+ * update does not have to be copied whole first. */
+#define SHA256_CDC_SLICE (4 * 1024 * 1024)
+
+/* 256 pseudo-random 64-bit values (splitmix64 from a fixed seed); changing
+ * them moves every boundary. */
+struct GearTable {
+    uint64_t v[256];
+};
+
+static constexpr GearTable make_gear() {
+    GearTable table = {};
+    uint64_t x = 0x6765617263646321ull;
+    for (int i = 0; i < 256; i++) {
+        x += 0x9e3779b97f4a7c15ull;
+        uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        table.v[i] = z ^ (z >> 31);
+    }
+    return table;
+}
+
+static constexpr GearTable gear = make_gear();
+
+/* The top `bits` bits: they depend on the most bytes of the window. */
+static uint64_t top_mask(unsigned bits) {
+    return bits >= 64 ? ~0ull : ~(~0ull >> bits);
+}
+
+bool cdc_Params(size_t min_size, size_t avg_size, size_t max_size, CdcParams* params) {
+    // ChunkRecord::length is 32 bits, so no chunk may be longer
+    if (avg_size < 64 || max_size == 0 || avg_size > UINT32_MAX || max_size > UINT32_MAX) {
+        return false;
+    }
+    unsigned bits = 0;
+    while (((size_t)2 << bits) <= avg_size) {
+        bits++;
+    }
+    avg_size = (size_t)1 << bits;
+    params->avg_size = avg_size;
+    params->min_size = min_size < avg_size ? min_size : avg_size;
+    params->max_size = max_size > avg_size ? max_size : avg_size;
+    params->mask_small = top_mask(bits + 2);
+    params->mask_large = top_mask(bits - 2);
+    return true;
+}
+
+size_t cdc_Cut(const uint8_t* data, size_t len, const CdcParams& params) {
+    if (len <= params.min_size) {
+        return len;
+    }
+    size_t end = len < params.max_size ? len : params.max_size;
+    size_t normal = end < params.avg_size ? end : params.avg_size;
+    uint64_t hash = 0;
+    size_t i = params.min_size;
+    for (; i < normal; i++) {
+        hash = (hash << 1) + gear.v[data[i]];
+        if (!(hash & params.mask_small)) {
+            return i + 1;
+        }
+    }
+    for (; i < end; i++) {
+        hash = (hash << 1) + gear.v[data[i]];
+        if (!(hash & params.mask_large)) {
+            return i + 1;
+        }
+    }
+    return end;
+}
+
+Sha256Chunker::Sha256Chunker(const CdcParams& params, ThreadPool* pool)
+    : params_(params), pool_(pool ? pool : &ThreadPool::shared()), offset_(0), in_flight_(0) {
+}
+
+Sha256Chunker::~Sha256Chunker() {
+    wait(0);
+}
+
+void Sha256Chunker::update(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        size_t n = len < SHA256_CDC_SLICE ? len : SHA256_CDC_SLICE;
+        tail_.insert(tail_.end(), data, data + n);
+        data += n;
+        len -= n;
+        if (tail_.size() >= params_.max_size) {
+            cut(false);
+        }
+    }
+}
+
+/* Cuts every chunk that is certain (all of them when final), moves their
+ * bytes into one shared buffer and queues a hash task per chunk. */
+void Sha256Chunker::cut(bool final) {
+    size_t size = tail_.size();
+    size_t start = 0;
+    size_t first = records_.size();
+    while (size - start >= params_.max_size || (final && start < size)) {
+        size_t n = cdc_Cut(tail_.data() + start, size - start, params_);
+        records_.push_back({offset_ + start, (uint32_t)n, 0, {0}});
+        start += n;
+    }
+    if (start == 0) {
+        return;
+    }
+
+    auto batch = std::make_shared<std::vector<uint8_t>>(std::move(tail_));
+    tail_.assign(batch->begin() + start, batch->end());
+    offset_ += start;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        in_flight_ += start;
+    }
+
+    size_t pos = 0;
+    for (size_t i = first; i < records_.size(); i++) {
+        /* deque::push_back never moves existing elements, so the pointer
+         * stays valid while later chunks are appended. */
+        ChunkRecord* record = &records_[i];
+        pool_->submit([this, batch, pos, record] {
+            sha256_Raw(batch->data() + pos, record->length, record->digest);
+            std::lock_guard<std::mutex> lock(mutex_);
+            in_flight_ -= record->length;
+            done_.notify_all();
+        });
+        pos += record->length;
+    }
+    wait(SHA256_CDC_IN_FLIGHT);
+}
+
+void Sha256Chunker::wait(size_t in_flight) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return in_flight_ <= in_flight; });
+}
+
+const std::vector<ChunkRecord>& Sha256Chunker::finish() {
+    cut(true);
+    wait(0);
+    manifest_.assign(records_.begin(), records_.end());
+    records_.clear();
+    tail_.clear();
+    offset_ = 0;
+    return manifest_;
+}
+
+size_t ChunkIndex::DigestHash::operator()(const std::string& digest) const {
+    /* Digests are uniformly distributed already. */
+    size_t h;
+    memcpy(&h, digest.data(), sizeof(h));
+    return h;
+}
+
+bool ChunkIndex::insert(const uint8_t digest[SHA256_DIGEST_LENGTH], uint32_t length) {
+    if (!digests_.emplace((const char*)digest, SHA256_DIGEST_LENGTH).second) {
+        return false;
+    }
+    bytes_ += length;
+    return true;
+}
+
+bool ChunkIndex::contains(const uint8_t digest[SHA256_DIGEST_LENGTH]) const {
+    return digests_.count(std::string((const char*)digest, SHA256_DIGEST_LENGTH)) != 0;
+}
+
+size_t ChunkIndex::add(const ChunkRecord* records, size_t n, bool* known) {
+    size_t added = 0;
+    for (size_t i = 0; i < n; i++) {
+        bool inserted = insert(records[i].digest, records[i].length);
+        if (known) {
+            known[i] = !inserted;
+        }
+        added += inserted;
+    }
+    return added;
+}
+
+void ChunkIndex::clear() {
+    digests_.clear();
+    bytes_ = 0;
+}
+
+} // namespace Hello
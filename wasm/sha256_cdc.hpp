@@ -0,0 +1,136 @@
+#ifndef HELLO_SHA_256_CDC_HPP
+#define HELLO_SHA_256_CDC_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+class ThreadPool;
+
+/*** CONTENT-DEFINED CHUNKING *****************************************/
+/*
+ * FastCDC: a Gear rolling hash (h = (h << 1) + gear[byte]) is tested
+ * against a mask after every byte, and a chunk ends where the masked bits
+ * are all zero. Because the hash only depends on the last 64 bytes, an edit
+ * moves the boundaries near it and leaves every other chunk, and therefore
+ * its digest, unchanged.
+ *
+ * Boundaries are never placed before min_size bytes, and a chunk is cut at
+ * max_size bytes if no boundary turns up. Normalized chunking keeps sizes
+ * close to avg_size (a power of two): up to avg_size the mask has two more
+ * bits than log2(avg_size), after it two fewer.
+ */
+#define SHA256_CDC_MIN_SIZE (16 * 1024)
+#define SHA256_CDC_AVG_SIZE (64 * 1024)
+#define SHA256_CDC_MAX_SIZE (256 * 1024)
+
+struct CdcParams {
+    size_t min_size;
+    size_t avg_size;
+    size_t max_size;
+    uint64_t mask_small; // used before avg_size
+    uint64_t mask_large; // used from avg_size on
+};
+
+// Validates and completes the sizes: avg_size is rounded down to a power
+// of two, and min_size and max_size are clamped so that min_size <=
+// avg_size <= max_size. Returns false (leaving params untouched) if
+// avg_size is below 64, max_size is zero, or either is above UINT32_MAX
+// (ChunkRecord::length holds a whole chunk in 32 bits).
+bool cdc_Params(size_t min_size, size_t avg_size, size_t max_size, CdcParams* params);
+
+// Length of the first chunk of data[0, len). Unless data is the rest of
+// the input it must hold at least max_size bytes, or the chunk would be cut
+// short at len.
+size_t cdc_Cut(const uint8_t* data, size_t len, const CdcParams& params);
+
+// One entry of a chunk manifest.
+struct ChunkRecord {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t reserved;
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+};
+
+// Streaming chunker: update() cuts chunks on the calling thread and hands
+// each one to pool (the shared pool when null) to be hashed, so chunking
+// and hashing overlap. Only the uncut tail (< max_size) and chunks still
+// waiting for a hash thread are kept, and update() blocks while more than
+// SHA256_CDC_IN_FLIGHT bytes are waiting. Without pool workers chunks are
+// hashed inline.
+#define SHA256_CDC_IN_FLIGHT (64 * 1024 * 1024)
+
+class Sha256Chunker {
+public:
+    explicit Sha256Chunker(const CdcParams& params, ThreadPool* pool = nullptr);
+    ~Sha256Chunker();
+
+    Sha256Chunker(const Sha256Chunker&) = delete;
+    Sha256Chunker& operator=(const Sha256Chunker&) = delete;
+
+    void update(const uint8_t* data, size_t len);
+
+    // Cuts the tail as the last chunk, waits for every hash and returns the
+    // manifest in input order. An empty input has no chunks. The chunker
+    // can be reused after finish().
+    const std::vector<ChunkRecord>& finish();
+
+    // Bytes fed since the last finish().
+    uint64_t total() const { return offset_ + tail_.size(); }
+
+private:
+    void cut(bool final);
+    void wait(size_t in_flight);
+
+    CdcParams params_;
+    ThreadPool* pool_;
+    std::vector<uint8_t> tail_;
+    uint64_t offset_; // input offset of tail_[0]
+    std::deque<ChunkRecord> records_;
+    std::vector<ChunkRecord> manifest_;
+
+    std::mutex mutex_;
+    std::condition_variable done_;
+    size_t in_flight_; // bytes submitted and not yet hashed
+};
+
+// Set of chunk digests already stored, for deduplication. Not synchronized.
+class ChunkIndex {
+public:
+    // Adds the digest; returns false if it was already known.
+    bool insert(const uint8_t digest[SHA256_DIGEST_LENGTH], uint32_t length);
+    bool contains(const uint8_t digest[SHA256_DIGEST_LENGTH]) const;
+
+    // Sets known[i] (when known is non-null) for each record whose digest
+    // was already indexed, counting earlier records of the same call, and
+    // adds the rest. Returns the number of new records.
+    size_t add(const ChunkRecord* records, size_t n, bool* known);
+
+    size_t size() const { return digests_.size(); }
+    // Bytes of unique chunks indexed.
+    uint64_t bytes() const { return bytes_; }
+    void clear();
+
+private:
+    struct DigestHash {
+        size_t operator()(const std::string& digest) const;
+    };
+
+    std::unordered_set<std::string, DigestHash> digests_;
+    uint64_t bytes_ = 0;
+};
+
+} // namespace Hello
+
+#endif
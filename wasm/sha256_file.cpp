@@ -0,0 +1,123 @@
+#include "sha256_file.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "memzero.hpp"
+#include "thread_pool.hpp"
+
+namespace Hello
+{
+
+static int sha256_ReadFd(int fd, SHA256_CTX* context) {
+    std::vector<uint8_t> buffer(SHA256_FILE_READ_SIZE);
+    for (;;) {
+        ssize_t n = read(fd, buffer.data(), buffer.size());
+        if (n > 0) {
+            sha256_Update(context, buffer.data(), (size_t)n);
+        } else if (n == 0) {
+            return 0;
+        } else if (errno != EINTR) {
+            return errno;
+        }
+    }
+}
+
+/* Returns -1 when the file can't be mapped at all, so the caller can fall
+ * back to read() before anything has been hashed. Touching a mapped page
+ * past the end of a file raises SIGBUS, so the size is checked again before
+ * each window; once the file is shorter than the window, the rest is hashed
+ * with read() from that offset instead. */
+static int sha256_MapFd(int fd, uint64_t size, SHA256_CTX* context) {
+    for (uint64_t offset = 0; offset < size; offset += SHA256_FILE_WINDOW) {
+        size_t n = (size - offset < SHA256_FILE_WINDOW) ? (size_t)(size - offset) : SHA256_FILE_WINDOW;
+        struct stat st;
+        if (offset > 0 && (fstat(fd, &st) != 0 || (uint64_t)st.st_size < offset + n)) {
+            if (lseek(fd, (off_t)offset, SEEK_SET) < 0) {
+                return errno;
+            }
+            return sha256_ReadFd(fd, context);
+        }
+        void* window = mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, (off_t)offset);
+        if (window == MAP_FAILED) {
+            return (offset == 0) ? -1 : errno;
+        }
+#ifdef MADV_SEQUENTIAL
+        madvise(window, n, MADV_SEQUENTIAL);
+#endif
+        sha256_Update(context, (const uint8_t*)window, n);
+        munmap(window, n);
+    }
+    return 0;
+}
+
+int sha256_Fd(int fd, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    SHA256_CTX context;
+    sha256_Init(&context);
+
+    int error = -1;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        /* Start from the current position so "-" redirected from a file
+         * behaves like a read. */
+        off_t start = lseek(fd, 0, SEEK_CUR);
+        if (start == 0) {
+            error = sha256_MapFd(fd, (uint64_t)st.st_size, &context);
+        }
+    }
+    if (error < 0) {
+        error = sha256_ReadFd(fd, &context);
+    }
+
+    if (error == 0) {
+        sha256_Final(&context, digest);
+    } else {
+        memzero(&context, sizeof(context));
+    }
+    return error;
+}
+
+int sha256_File(const char* path, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    if (strcmp(path, "-") == 0) {
+        return sha256_Fd(STDIN_FILENO, digest);
+    }
+    int fd;
+    do {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return errno;
+    }
+    int error = sha256_Fd(fd, digest);
+    close(fd);
+    return error;
+}
+
+const Data sha256_file(const std::string& path) {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    int error = sha256_File(path.c_str(), digest);
+    if (error != 0) {
+        throw std::runtime_error(path + ": " + strerror(error));
+    }
+    return Data(digest, digest + SHA256_DIGEST_LENGTH);
+}
+
+std::vector<FileDigest> sha256_files(const std::vector<std::string>& paths, ThreadPool* pool) {
+    std::vector<FileDigest> results(paths.size());
+    if (pool == nullptr) {
+        pool = &ThreadPool::shared();
+    }
+    pool->parallel_for(paths.size(), [&](size_t i) {
+        results[i].path = paths[i];
+        results[i].error = sha256_File(paths[i].c_str(), results[i].digest);
+    });
+    return results;
+}
+
+} // namespace Hello
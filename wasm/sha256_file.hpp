@@ -0,0 +1,57 @@
+#ifndef HELLO_SHA_256_FILE_HPP
+#define HELLO_SHA_256_FILE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "data.hpp"
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+class ThreadPool;
+
+/*** FILE HASHING *****************************************************/
+/*
+ * Regular files are mapped one window at a time (SHA256_FILE_WINDOW bytes,
+ * advised MADV_SEQUENTIAL) and unmapped as soon as the window is hashed, so
+ * resident memory stays at about one window per hashing thread whatever the
+ * file size. Pipes, ttys and anything else mmap refuses are read through a
+ * SHA256_FILE_READ_SIZE buffer instead.
+ *
+ * A file that shrinks while it is hashed (truncated or rewritten) switches
+ * to read() at the next window, where its size is checked again. One cut
+ * short while a window is being hashed still raises SIGBUS, as with any
+ * mapped file; hash files that may be truncated concurrently through a
+ * pipe ("-" reads stdin).
+ */
+#define SHA256_FILE_WINDOW (16 * 1024 * 1024)
+#define SHA256_FILE_READ_SIZE (256 * 1024)
+
+// Hashes everything readable from fd. Returns 0 or an errno value.
+int sha256_Fd(int fd, uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// Hashes the file at path; "-" is stdin. Returns 0 or an errno value.
+int sha256_File(const char* path, uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// Calculates the SHA256 digest of the file at path; throws runtime_error
+// naming the path when it can't be opened or read.
+const Data sha256_file(const std::string& path);
+
+struct FileDigest {
+    std::string path;
+    int error;  // 0 on success, otherwise an errno value
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+};
+
+// Hashes every path concurrently on pool (the shared pool when null).
+// Results come back in the order of paths; failures are reported per file.
+std::vector<FileDigest> sha256_files(const std::vector<std::string>& paths, ThreadPool* pool = nullptr);
+
+} // namespace Hello
+
+#endif
@@ -0,0 +1,67 @@
+#include "sha256_fixed.hpp"
+
+#include <string.h>
+
+#include "memzero.hpp"
+#include "sha256_multi.hpp"
+
+namespace Hello
+{
+
+/* Nodes compressed per sha256_TransformMany call. */
+#define SHA256_32_GROUP 64
+
+static const uint8_t sha256_zero_node[SHA256_DIGEST_LENGTH] = {0};
+
+static inline uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+void sha256_32(const uint8_t in[SHA256_DIGEST_LENGTH], uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    sha256_fixed<SHA256_DIGEST_LENGTH>(in, digest);
+}
+
+void sha256_64(const uint8_t in[2 * SHA256_DIGEST_LENGTH], uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    sha256_fixed<2 * SHA256_DIGEST_LENGTH>(in, digest);
+}
+
+void sha256d(const uint8_t* data, size_t len, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    uint8_t inner[SHA256_DIGEST_LENGTH];
+    sha256_Raw(data, len, inner);
+    sha256_32(inner, digest);
+    memzero(inner, sizeof(inner));
+}
+
+void sha256_32Batch(const uint8_t (*nodes)[SHA256_DIGEST_LENGTH], size_t n, uint8_t (*digests)[SHA256_DIGEST_LENGTH]) {
+    uint32_t states[SHA256_32_GROUP][8];
+    uint32_t blocks[SHA256_32_GROUP][16];
+
+    /* Words 8..15 are the same padding for every node. */
+    for (size_t g = 0; g < SHA256_32_GROUP; g++) {
+        memcpy(states[g], sha256_initial_hash_value, sizeof(states[g]));
+        sha256_fixed_block<SHA256_DIGEST_LENGTH, 0>(sha256_zero_node, blocks[g], std::make_index_sequence<16>());
+    }
+    for (size_t base = 0; base < n; base += SHA256_32_GROUP) {
+        size_t count = (n - base < SHA256_32_GROUP) ? n - base : SHA256_32_GROUP;
+        for (size_t g = 0; g < count; g++) {
+            const uint8_t* node = nodes[base + g];
+            for (int j = 0; j < 8; j++) {
+                blocks[g][j] = read_be32(node + j * 4);
+            }
+        }
+        uint32_t out[SHA256_32_GROUP][8];
+        sha256_TransformMany(states, blocks, out, count);
+        for (size_t g = 0; g < count; g++) {
+            for (int j = 0; j < 8; j++) {
+                digests[base + g][j * 4] = (uint8_t)(out[g][j] >> 24);
+                digests[base + g][j * 4 + 1] = (uint8_t)(out[g][j] >> 16);
+                digests[base + g][j * 4 + 2] = (uint8_t)(out[g][j] >> 8);
+                digests[base + g][j * 4 + 3] = (uint8_t)out[g][j];
+            }
+        }
+        memzero(out, sizeof(out));
+    }
+    memzero(blocks, sizeof(blocks));
+}
+
+} // namespace Hello
@@ -0,0 +1,90 @@
+#ifndef HELLO_SHA_256_FIXED_HPP
+#define HELLO_SHA_256_FIXED_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+/*** FIXED-LENGTH FAST PATHS ******************************************/
+/*
+ * When the length is a compile-time constant the padded message is known
+ * word by word: input words are loaded big-endian straight from the input,
+ * and the 0x80 marker, zero fill and bit length are constants. The blocks
+ * go to sha256_Transform directly, with none of the SHA256_CTX buffering,
+ * byte swapping or wiping that sha256_Raw does.
+ */
+template <size_t N>
+struct Sha256FixedLayout {
+    static constexpr size_t blocks = (N + 9 + SHA256_BLOCK_LENGTH - 1) / SHA256_BLOCK_LENGTH;
+    static constexpr size_t words = blocks * 16;
+    static constexpr uint64_t bits = (uint64_t)N * 8;
+};
+
+// Word K of the padded N-byte message.
+template <size_t N, size_t K>
+static inline __attribute__((always_inline)) uint32_t sha256_fixed_word(const uint8_t* in) {
+    constexpr size_t offset = K * 4;
+    if constexpr (K == Sha256FixedLayout<N>::words - 2) {
+        return (uint32_t)(Sha256FixedLayout<N>::bits >> 32);
+    } else if constexpr (K == Sha256FixedLayout<N>::words - 1) {
+        return (uint32_t)Sha256FixedLayout<N>::bits;
+    } else if constexpr (offset + 4 <= N) {
+        return ((uint32_t)in[offset] << 24) | ((uint32_t)in[offset + 1] << 16) | ((uint32_t)in[offset + 2] << 8) | (uint32_t)in[offset + 3];
+    } else if constexpr (offset > N) {
+        return 0;
+    } else {
+        uint32_t w = 0x80000000UL >> (8 * (N - offset));
+        for (size_t i = 0; offset + i < N; i++) {
+            w |= (uint32_t)in[offset + i] << (24 - 8 * i);
+        }
+        return w;
+    }
+}
+
+template <size_t N, size_t B, size_t... J>
+static inline __attribute__((always_inline)) void sha256_fixed_block(const uint8_t* in, uint32_t w[16], std::index_sequence<J...>) {
+    ((w[J] = sha256_fixed_word<N, B * 16 + J>(in)), ...);
+}
+
+template <size_t N, size_t... B>
+static inline __attribute__((always_inline)) void sha256_fixed_blocks(const uint8_t* in, uint32_t state[8], std::index_sequence<B...>) {
+    uint32_t w[16];
+    const uint32_t* from = sha256_initial_hash_value;
+    ((sha256_fixed_block<N, B>(in, w, std::make_index_sequence<16>()), sha256_Transform(from, w, state), from = state), ...);
+}
+
+// SHA256 of exactly N bytes.
+template <size_t N>
+inline void sha256_fixed(const uint8_t* in, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    uint32_t state[8];
+    sha256_fixed_blocks<N>(in, state, std::make_index_sequence<Sha256FixedLayout<N>::blocks>());
+    for (int j = 0; j < 8; j++) {
+        digest[j * 4] = (uint8_t)(state[j] >> 24);
+        digest[j * 4 + 1] = (uint8_t)(state[j] >> 16);
+        digest[j * 4 + 2] = (uint8_t)(state[j] >> 8);
+        digest[j * 4 + 3] = (uint8_t)state[j];
+    }
+}
+
+// One compression: SHA256 of a 32-byte value, e.g. a digest.
+void sha256_32(const uint8_t in[SHA256_DIGEST_LENGTH], uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// Two compressions: SHA256 of a 64-byte value, e.g. two child digests.
+void sha256_64(const uint8_t in[2 * SHA256_DIGEST_LENGTH], uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// SHA256(SHA256(data)); the outer hash is sha256_32.
+void sha256d(const uint8_t* data, size_t len, uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// digests[i] = sha256_32(nodes[i]). Every message is the same single padded
+// block shape, so the nodes run side by side through sha256_TransformMany.
+void sha256_32Batch(const uint8_t (*nodes)[SHA256_DIGEST_LENGTH], size_t n, uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+
+} // namespace Hello
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Hardware SHA-256 compression backends for sha256_Transform.
+ *
+ * Each comes in two shapes, like the portable code: one compression of a
+ * block of host-order words (sha256_Transform), and a run of big-endian
+ * blocks loaded straight from the input with the state kept in registers
+ * throughout (sha256_Transform_blocks). Each is compiled with a
+ * per-function target attribute; whether it may run is decided at runtime
+ * by sha256_BackendSupported.
+ */
+
+#include "sha256.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HELLO_SHA256_HW_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define HELLO_SHA256_HW_ARMV8 1
+#include <arm_neon.h>
+#if defined(__clang__)
+#define HELLO_TARGET_ARM_SHA2 __attribute__((target("sha2")))
+#else
+#define HELLO_TARGET_ARM_SHA2 __attribute__((target("+sha2")))
+#endif
+#endif
+
+namespace Hello
+{
+
+/*** x86 SHA EXTENSIONS ***********************************************/
+#ifdef HELLO_SHA256_HW_X86
+#define HELLO_TARGET_SHANI __attribute__((target("sha,sse4.1,ssse3")))
+
+/* SHA256RNDS2 wants the state split as ABEF / CDGH. */
+static inline HELLO_TARGET_SHANI __attribute__((always_inline)) void sha256_shani_load(const uint32_t* state, __m128i* state0, __m128i* state1) {
+    __m128i tmp = _mm_loadu_si128((const __m128i*)&state[0]);
+    *state1 = _mm_loadu_si128((const __m128i*)&state[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);
+    *state1 = _mm_shuffle_epi32(*state1, 0x1B);
+    *state0 = _mm_alignr_epi8(tmp, *state1, 8);
+    *state1 = _mm_blend_epi16(*state1, tmp, 0xF0);
+}
+
+/* Back to ABCD / EFGH. */
+static inline HELLO_TARGET_SHANI __attribute__((always_inline)) void sha256_shani_store(__m128i state0, __m128i state1, uint32_t* state) {
+    __m128i tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+    _mm_storeu_si128((__m128i*)&state[0], state0);
+    _mm_storeu_si128((__m128i*)&state[4], state1);
+}
+
+/* Sixteen groups of four rounds; w[i & 3] holds W[4i..4i+3]. */
+static inline HELLO_TARGET_SHANI __attribute__((always_inline)) void sha256_shani_rounds(__m128i* state0, __m128i* state1, __m128i w[4]) {
+    __m128i msg, tmp;
+    __m128i abef_save = *state0;
+    __m128i cdgh_save = *state1;
+
+    for (int i = 0; i < 16; i++) {
+        if (i >= 4) {
+            tmp = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+            tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4));
+            w[i & 3] = _mm_sha256msg2_epu32(tmp, w[(i + 3) & 3]);
+        }
+        msg = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i*)&sha256_K256[i * 4]));
+        *state1 = _mm_sha256rnds2_epu32(*state1, *state0, msg);
+        msg = _mm_shuffle_epi32(msg, 0x0E);
+        *state0 = _mm_sha256rnds2_epu32(*state0, *state1, msg);
+    }
+
+    *state0 = _mm_add_epi32(*state0, abef_save);
+    *state1 = _mm_add_epi32(*state1, cdgh_save);
+}
+
+HELLO_TARGET_SHANI void sha256_Transform_shani(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out) {
+    __m128i state0, state1;
+    __m128i w[4];
+
+    sha256_shani_load(state_in, &state0, &state1);
+    w[0] = _mm_loadu_si128((const __m128i*)&data[0]);
+    w[1] = _mm_loadu_si128((const __m128i*)&data[4]);
+    w[2] = _mm_loadu_si128((const __m128i*)&data[8]);
+    w[3] = _mm_loadu_si128((const __m128i*)&data[12]);
+    sha256_shani_rounds(&state0, &state1, w);
+    sha256_shani_store(state0, state1, state_out);
+}
+
+HELLO_TARGET_SHANI void sha256_Transform_blocks_shani(uint32_t* state, const uint8_t* data, size_t nblocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1;
+    __m128i w[4];
+
+    sha256_shani_load(state, &state0, &state1);
+    for (size_t i = 0; i < nblocks; i++, data += 64) {
+        w[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap);
+        w[1] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap);
+        w[2] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap);
+        w[3] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap);
+        sha256_shani_rounds(&state0, &state1, w);
+    }
+    sha256_shani_store(state0, state1, state);
+}
+#else
+void sha256_Transform_shani(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out) {
+    sha256_Transform_portable(state_in, data, state_out);
+}
+
+void sha256_Transform_blocks_shani(uint32_t* state, const uint8_t* data, size_t nblocks) {
+    sha256_Transform_blocks_portable(state, data, nblocks);
+}
+#endif
+
+/*** ARMv8 CRYPTOGRAPHY EXTENSIONS ************************************/
+#ifdef HELLO_SHA256_HW_ARMV8
+/* Sixteen groups of four rounds; w[i & 3] holds W[4i..4i+3]. */
+static inline HELLO_TARGET_ARM_SHA2 __attribute__((always_inline)) void sha256_armv8_rounds(uint32x4_t* state0, uint32x4_t* state1, uint32x4_t w[4]) {
+    uint32x4_t abcd, tmp;
+    uint32x4_t abcd_save = *state0;
+    uint32x4_t efgh_save = *state1;
+
+    for (int i = 0; i < 16; i++) {
+        if (i >= 4) {
+            w[i & 3] = vsha256su1q_u32(vsha256su0q_u32(w[i & 3], w[(i + 1) & 3]), w[(i + 2) & 3], w[(i + 3) & 3]);
+        }
+        tmp = vaddq_u32(w[i & 3], vld1q_u32(&sha256_K256[i * 4]));
+        abcd = *state0;
+        *state0 = vsha256hq_u32(*state0, *state1, tmp);
+        *state1 = vsha256h2q_u32(*state1, abcd, tmp);
+    }
+
+    *state0 = vaddq_u32(*state0, abcd_save);
+    *state1 = vaddq_u32(*state1, efgh_save);
+}
+
+HELLO_TARGET_ARM_SHA2 void sha256_Transform_armv8(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out) {
+    uint32x4_t state0 = vld1q_u32(&state_in[0]);
+    uint32x4_t state1 = vld1q_u32(&state_in[4]);
+    uint32x4_t w[4];
+
+    w[0] = vld1q_u32(&data[0]);
+    w[1] = vld1q_u32(&data[4]);
+    w[2] = vld1q_u32(&data[8]);
+    w[3] = vld1q_u32(&data[12]);
+    sha256_armv8_rounds(&state0, &state1, w);
+
+    vst1q_u32(&state_out[0], state0);
+    vst1q_u32(&state_out[4], state1);
+}
+
+HELLO_TARGET_ARM_SHA2 void sha256_Transform_blocks_armv8(uint32_t* state, const uint8_t* data, size_t nblocks) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+    uint32x4_t w[4];
+
+    for (size_t i = 0; i < nblocks; i++, data += 64) {
+        w[0] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 0)));
+        w[1] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16)));
+        w[2] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 32)));
+        w[3] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 48)));
+        sha256_armv8_rounds(&state0, &state1, w);
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+#else
+void sha256_Transform_armv8(const uint32_t* state_in, const uint32_t* data, uint32_t* state_out) {
+    sha256_Transform_portable(state_in, data, state_out);
+}
+
+void sha256_Transform_blocks_armv8(uint32_t* state, const uint8_t* data, size_t nblocks) {
+    sha256_Transform_blocks_portable(state, data, nblocks);
+}
+#endif
+
+} // namespace Hello
@@ -0,0 +1,161 @@
+#include "sha256_midstate.hpp"
+
+#include <string.h>
+
+#include "memzero.hpp"
+#include "sha256_multi.hpp"
+
+namespace Hello
+{
+
+#define SHA256_SHORT_BLOCK_LENGTH (SHA256_BLOCK_LENGTH - 8)
+
+/* Single-block suffixes resumed per sha256_TransformMany call. */
+#define SHA256_RESUME_GROUP 64
+
+static inline uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void write_be32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t)(x >> 24);
+    p[1] = (uint8_t)(x >> 16);
+    p[2] = (uint8_t)(x >> 8);
+    p[3] = (uint8_t)x;
+}
+
+/*** MIDSTATES ********************************************************/
+void sha256_SaveMidstate(const SHA256_CTX* context, uint8_t out[SHA256_MIDSTATE_LENGTH]) {
+    size_t used = (context->bitcount >> 3) % SHA256_BLOCK_LENGTH;
+
+    out[0] = SHA256_MIDSTATE_VERSION;
+    for (int j = 0; j < 8; j++) {
+        write_be32(out + 1 + j * 4, context->state[j]);
+    }
+    write_be32(out + 33, (uint32_t)(context->bitcount >> 32));
+    write_be32(out + 37, (uint32_t)context->bitcount);
+    /* Buffered bytes are kept in message order until a block fills up. */
+    memcpy(out + 41, context->buffer, used);
+    memset(out + 41 + used, 0, SHA256_BLOCK_LENGTH - used);
+}
+
+bool sha256_LoadMidstate(SHA256_CTX* context, const uint8_t in[SHA256_MIDSTATE_LENGTH]) {
+    if (in[0] != SHA256_MIDSTATE_VERSION) {
+        return false;
+    }
+    for (int j = 0; j < 8; j++) {
+        context->state[j] = read_be32(in + 1 + j * 4);
+    }
+    context->bitcount = ((uint64_t)read_be32(in + 33) << 32) | read_be32(in + 37);
+    memcpy(context->buffer, in + 41, SHA256_BLOCK_LENGTH);
+    return true;
+}
+
+void sha256_Resume(const SHA256_CTX* midstate, const uint8_t* suffix, size_t len, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    SHA256_CTX context;
+    memcpy(&context, midstate, sizeof(context));
+    sha256_Update(&context, suffix, len);
+    sha256_Final(&context, digest);
+}
+
+void sha256_ResumeBatch(const SHA256_CTX* midstate, const uint8_t* const* suffixes, const size_t* lens, size_t n,
+                        uint8_t (*digests)[SHA256_DIGEST_LENGTH]) {
+    uint32_t states[SHA256_RESUME_GROUP][8];
+    uint32_t blocks[SHA256_RESUME_GROUP][16];
+    size_t owner[SHA256_RESUME_GROUP];
+    uint8_t block[SHA256_BLOCK_LENGTH];
+    size_t used = (midstate->bitcount >> 3) % SHA256_BLOCK_LENGTH;
+    size_t grouped = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (used + lens[i] >= SHA256_SHORT_BLOCK_LENGTH) {
+            sha256_Resume(midstate, suffixes[i], lens[i], digests[i]);
+        } else {
+            /* Lay out the final padded block directly. */
+            uint64_t bitcount = midstate->bitcount + ((uint64_t)lens[i] << 3);
+            memcpy(block, midstate->buffer, used);
+            memcpy(block + used, suffixes[i], lens[i]);
+            block[used + lens[i]] = 0x80;
+            memset(block + used + lens[i] + 1, 0, SHA256_SHORT_BLOCK_LENGTH - used - lens[i] - 1);
+            write_be32(block + 56, (uint32_t)(bitcount >> 32));
+            write_be32(block + 60, (uint32_t)bitcount);
+            for (int j = 0; j < 16; j++) {
+                blocks[grouped][j] = read_be32(block + j * 4);
+            }
+            memcpy(states[grouped], midstate->state, sizeof(states[grouped]));
+            owner[grouped++] = i;
+        }
+
+        if (grouped == SHA256_RESUME_GROUP || (i + 1 == n && grouped > 0)) {
+            sha256_TransformMany(states, blocks, states, grouped);
+            for (size_t g = 0; g < grouped; g++) {
+                for (int j = 0; j < 8; j++) {
+                    write_be32(digests[owner[g]] + j * 4, states[g][j]);
+                }
+            }
+            grouped = 0;
+        }
+    }
+
+    memzero(states, sizeof(states));
+    memzero(blocks, sizeof(blocks));
+    memzero(block, sizeof(block));
+}
+
+/*** PREFIX CACHE *****************************************************/
+Sha256PrefixCache::Sha256PrefixCache(size_t capacity) : capacity_(capacity > 0 ? capacity : 1), hits_(0), misses_(0) {
+}
+
+Sha256PrefixCache::~Sha256PrefixCache() {
+    clear();
+}
+
+/* The prefix may be secret (e.g. a keyed header), so an entry leaving the
+ * cache wipes its copy along with the midstate before the memory is freed.
+ * Its index key must already be gone, since the key views these bytes. */
+static void wipe_entry(std::string& prefix, SHA256_CTX& context) {
+    if (!prefix.empty()) {
+        memzero(&prefix[0], prefix.size());
+    }
+    memzero(&context, sizeof(context));
+}
+
+const SHA256_CTX& Sha256PrefixCache::midstate(const uint8_t* prefix, size_t len) {
+    auto found = index_.find(std::string_view((const char*)prefix, len));
+    if (found != index_.end()) {
+        hits_++;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return found->second->context;
+    }
+
+    misses_++;
+    if (entries_.size() >= capacity_) {
+        Entry& last = entries_.back();
+        index_.erase(std::string_view(last.prefix));
+        wipe_entry(last.prefix, last.context);
+        entries_.pop_back();
+    }
+    entries_.emplace_front();
+    Entry& entry = entries_.front();
+    entry.prefix.assign((const char*)prefix, len);
+    sha256_Init(&entry.context);
+    sha256_Update(&entry.context, prefix, len);
+    /* The key views the entry's own copy, which never moves in the list. */
+    index_.emplace(std::string_view(entry.prefix), entries_.begin());
+    return entry.context;
+}
+
+void Sha256PrefixCache::hash(const uint8_t* prefix, size_t prefix_len, const uint8_t* suffix, size_t suffix_len,
+                             uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    sha256_Resume(&midstate(prefix, prefix_len), suffix, suffix_len, digest);
+}
+
+void Sha256PrefixCache::clear() {
+    index_.clear();
+    for (Entry& entry : entries_) {
+        wipe_entry(entry.prefix, entry.context);
+    }
+    entries_.clear();
+}
+
+} // namespace Hello
@@ -0,0 +1,85 @@
+#ifndef HELLO_SHA_256_MIDSTATE_HPP
+#define HELLO_SHA_256_MIDSTATE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+/*** MIDSTATES ********************************************************/
+/*
+ * A SHA256_CTX that has absorbed a shared prefix is a midstate: copying it
+ * and feeding only the suffix gives the same digest as hashing the whole
+ * message. The serialized form is fixed-size and byte-order independent:
+ *
+ *   u8 version (1) || u32 state[8] || u64 bitcount || 64-byte buffer
+ *
+ * with integers big-endian and only the buffered bytes of the buffer
+ * meaningful (the rest is written as zero).
+ */
+#define SHA256_MIDSTATE_VERSION 1
+#define SHA256_MIDSTATE_LENGTH (1 + 32 + 8 + SHA256_BLOCK_LENGTH)
+
+void sha256_SaveMidstate(const SHA256_CTX*, uint8_t[SHA256_MIDSTATE_LENGTH]);
+// Returns false, leaving the context untouched, for an unknown version.
+bool sha256_LoadMidstate(SHA256_CTX*, const uint8_t[SHA256_MIDSTATE_LENGTH]);
+
+// SHA256(prefix || suffix) for the prefix already absorbed by midstate.
+void sha256_Resume(const SHA256_CTX* midstate, const uint8_t* suffix, size_t len, uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// Resumes n suffixes from one midstate. Suffixes that finish in a single
+// block (buffered prefix bytes + suffix + padding <= 64 bytes) are
+// compressed side by side with sha256_TransformMany; longer ones go through
+// sha256_Resume.
+void sha256_ResumeBatch(const SHA256_CTX* midstate, const uint8_t* const* suffixes, const size_t* lens, size_t n,
+                        uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+
+// Least-recently-used cache of midstates keyed by the prefix bytes, so a
+// repeated prefix is absorbed once. An entry that is evicted or cleared has
+// its copy of the prefix and its midstate wiped. Not synchronized; keep one
+// per thread.
+class Sha256PrefixCache {
+public:
+    explicit Sha256PrefixCache(size_t capacity = 16);
+    ~Sha256PrefixCache();
+
+    Sha256PrefixCache(const Sha256PrefixCache&) = delete;
+    Sha256PrefixCache& operator=(const Sha256PrefixCache&) = delete;
+
+    // Midstate after prefix; valid until the next call that may evict.
+    const SHA256_CTX& midstate(const uint8_t* prefix, size_t len);
+
+    // SHA256(prefix || suffix).
+    void hash(const uint8_t* prefix, size_t prefix_len, const uint8_t* suffix, size_t suffix_len, uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+    // Wipes and drops every entry.
+    void clear();
+
+    size_t size() const { return entries_.size(); }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+
+private:
+    struct Entry {
+        std::string prefix;
+        SHA256_CTX context;
+    };
+
+    size_t capacity_;
+    size_t hits_;
+    size_t misses_;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+};
+
+} // namespace Hello
+
+#endif
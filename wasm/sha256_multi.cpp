@@ -0,0 +1,394 @@
+#include "sha256_multi.hpp"
+
+#include <string.h>
+
+#include "cpu.hpp"
+#include "memzero.hpp"
+
+// The lane-interleaved transform is written once against GCC/Clang vector
+// extensions and instantiated per instruction set: the compiler lowers the
+// same code to SSE2, AVX2, NEON or WASM SIMD128 depending on the target of
+// the function it is inlined into.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HELLO_SHA256_LANES_X86 1
+#elif defined(__GNUC__) && (defined(__wasm_simd128__) || defined(__ARM_NEON))
+#define HELLO_SHA256_LANES_4 1
+#endif
+
+namespace Hello
+{
+
+#define SHA256_SHORT_BLOCK_LENGTH (SHA256_BLOCK_LENGTH - 8)
+
+/* Same logical functions as sha256.cpp; they work unchanged on vectors. */
+#define SHR(b, x) ((x) >> (b))
+#define ROTR32(b, x) (((x) >> (b)) | ((x) << (32 - (b))))
+#define Ch(x, y, z) (((x) & (y)) ^ ((~(x)) & (z)))
+#define Maj(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define Sigma0_256(x) (ROTR32(2, (x)) ^ ROTR32(13, (x)) ^ ROTR32(22, (x)))
+#define Sigma1_256(x) (ROTR32(6, (x)) ^ ROTR32(11, (x)) ^ ROTR32(25, (x)))
+#define sigma0_256(x) (ROTR32(7, (x)) ^ ROTR32(18, (x)) ^ SHR(3, (x)))
+#define sigma1_256(x) (ROTR32(17, (x)) ^ ROTR32(19, (x)) ^ SHR(10, (x)))
+
+static inline uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void write_be32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t)(x >> 24);
+    p[1] = (uint8_t)(x >> 16);
+    p[2] = (uint8_t)(x >> 8);
+    p[3] = (uint8_t)x;
+}
+
+/*** LANE-INTERLEAVED TRANSFORM ***************************************/
+/*
+ * state holds the eight working words of every lane, word-major:
+ * state[k * N + lane]. blocks[lane] points at the 64 big-endian message
+ * bytes to absorb into that lane.
+ */
+typedef void (*sha256_lanes_fn)(uint32_t* state, const uint8_t* const* blocks);
+
+#if defined(HELLO_SHA256_LANES_X86) || defined(HELLO_SHA256_LANES_4)
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+#endif
+#if defined(HELLO_SHA256_LANES_X86)
+typedef uint32_t u32x8 __attribute__((vector_size(32)));
+#endif
+
+#if defined(HELLO_SHA256_LANES_X86) || defined(HELLO_SHA256_LANES_4)
+template <typename V>
+static inline __attribute__((always_inline)) void sha256_rounds_lanes(V* s, V* W256) {
+    V a, b, c, d, e, f, g, h, T1, T2;
+    int j = 0;
+
+    a = s[0];
+    b = s[1];
+    c = s[2];
+    d = s[3];
+    e = s[4];
+    f = s[5];
+    g = s[6];
+    h = s[7];
+
+    for (j = 0; j < 16; j++) {
+        T1 = h + Sigma1_256(e) + Ch(e, f, g) + sha256_K256[j] + W256[j];
+        T2 = Sigma0_256(a) + Maj(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + T1;
+        d = c;
+        c = b;
+        b = a;
+        a = T1 + T2;
+    }
+    for (; j < 64; j++) {
+        V s0 = sigma0_256(W256[(j + 1) & 0x0f]);
+        V s1 = sigma1_256(W256[(j + 14) & 0x0f]);
+        T1 = h + Sigma1_256(e) + Ch(e, f, g) + sha256_K256[j] + (W256[j & 0x0f] += s1 + W256[(j + 9) & 0x0f] + s0);
+        T2 = Sigma0_256(a) + Maj(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + T1;
+        d = c;
+        c = b;
+        b = a;
+        a = T1 + T2;
+    }
+
+    s[0] += a;
+    s[1] += b;
+    s[2] += c;
+    s[3] += d;
+    s[4] += e;
+    s[5] += f;
+    s[6] += g;
+    s[7] += h;
+}
+
+template <typename V, int N>
+static inline __attribute__((always_inline)) void sha256_transform_lanes(uint32_t* state, const uint8_t* const* blocks) {
+    V W256[16], s[8];
+
+    for (int j = 0; j < 16; j++) {
+        for (int lane = 0; lane < N; lane++) {
+            W256[j][lane] = read_be32(blocks[lane] + j * 4);
+        }
+    }
+    memcpy(s, state, sizeof(s));
+    sha256_rounds_lanes<V>(s, W256);
+    memcpy(state, s, sizeof(s));
+}
+
+/* Same rounds for N independent sha256_Transform calls: states and blocks
+ * arrive one per lane in host word order and are transposed on the way. */
+template <typename V, int N>
+static inline __attribute__((always_inline)) void sha256_transform_many_lanes(const uint32_t (*state_in)[8], const uint32_t (*data)[16],
+                                                                             uint32_t (*state_out)[8]) {
+    V W256[16], s[8];
+
+    for (int j = 0; j < 16; j++) {
+        for (int lane = 0; lane < N; lane++) {
+            W256[j][lane] = data[lane][j];
+        }
+    }
+    for (int k = 0; k < 8; k++) {
+        for (int lane = 0; lane < N; lane++) {
+            s[k][lane] = state_in[lane][k];
+        }
+    }
+    sha256_rounds_lanes<V>(s, W256);
+    for (int k = 0; k < 8; k++) {
+        for (int lane = 0; lane < N; lane++) {
+            state_out[lane][k] = s[k][lane];
+        }
+    }
+}
+#endif
+
+typedef void (*sha256_many_fn)(const uint32_t (*state_in)[8], const uint32_t (*data)[16], uint32_t (*state_out)[8]);
+
+#if defined(HELLO_SHA256_LANES_X86)
+__attribute__((target("sse2"))) static void sha256_transform_x4(uint32_t* state, const uint8_t* const* blocks) {
+    sha256_transform_lanes<u32x4, 4>(state, blocks);
+}
+
+__attribute__((target("avx2"))) static void sha256_transform_x8(uint32_t* state, const uint8_t* const* blocks) {
+    sha256_transform_lanes<u32x8, 8>(state, blocks);
+}
+
+__attribute__((target("sse2"))) static void sha256_many_x4(const uint32_t (*state_in)[8], const uint32_t (*data)[16], uint32_t (*state_out)[8]) {
+    sha256_transform_many_lanes<u32x4, 4>(state_in, data, state_out);
+}
+
+__attribute__((target("avx2"))) static void sha256_many_x8(const uint32_t (*state_in)[8], const uint32_t (*data)[16], uint32_t (*state_out)[8]) {
+    sha256_transform_many_lanes<u32x8, 8>(state_in, data, state_out);
+}
+#elif defined(HELLO_SHA256_LANES_4)
+static void sha256_transform_x4(uint32_t* state, const uint8_t* const* blocks) {
+    sha256_transform_lanes<u32x4, 4>(state, blocks);
+}
+
+static void sha256_many_x4(const uint32_t (*state_in)[8], const uint32_t (*data)[16], uint32_t (*state_out)[8]) {
+    sha256_transform_many_lanes<u32x4, 4>(state_in, data, state_out);
+}
+#endif
+
+/* Single-lane fallback: the scalar transform, reading the block in place. */
+static void sha256_transform_x1(uint32_t* state, const uint8_t* const* blocks) {
+    sha256_Transform_blocks(state, blocks[0], 1);
+}
+
+/*** LANE SCHEDULING **************************************************/
+#define SHA256_LANES_MAX 8
+#define SHA256_LANE_IDLE ((size_t)-1)
+
+typedef struct _SHA256_LANE {
+    const uint8_t* data;     /* Next full block still inside the message */
+    size_t full_blocks;      /* Full blocks left at data */
+    size_t tail_blocks;      /* Padded blocks left in tail (1 or 2) */
+    size_t tail_used;        /* Padded blocks of tail already handed out */
+    size_t index;            /* Message being hashed, or SHA256_LANE_IDLE */
+    uint8_t tail[2 * SHA256_BLOCK_LENGTH];
+} SHA256_LANE;
+
+static void sha256_lane_start(SHA256_LANE* lane, uint32_t* state, size_t lanes, size_t slot, const uint8_t* msg, size_t len, size_t index) {
+    size_t full = len / SHA256_BLOCK_LENGTH;
+    size_t rem = len % SHA256_BLOCK_LENGTH;
+    size_t padded = (rem < SHA256_SHORT_BLOCK_LENGTH) ? SHA256_BLOCK_LENGTH : 2 * SHA256_BLOCK_LENGTH;
+    uint64_t bitcount = (uint64_t)len << 3;
+
+    lane->data = msg;
+    lane->full_blocks = full;
+    lane->index = index;
+    lane->tail_used = 0;
+    lane->tail_blocks = padded / SHA256_BLOCK_LENGTH;
+
+    if (rem > 0) {
+        memcpy(lane->tail, msg + full * SHA256_BLOCK_LENGTH, rem);
+    }
+    lane->tail[rem] = 0x80;
+    memset(lane->tail + rem + 1, 0, padded - rem - 1 - 8);
+    write_be32(lane->tail + padded - 8, (uint32_t)(bitcount >> 32));
+    write_be32(lane->tail + padded - 4, (uint32_t)bitcount);
+
+    for (int k = 0; k < 8; k++) {
+        state[k * lanes + slot] = sha256_initial_hash_value[k];
+    }
+}
+
+static const uint8_t* sha256_lane_next(SHA256_LANE* lane) {
+    if (lane->full_blocks > 0) {
+        const uint8_t* block = lane->data;
+        lane->data += SHA256_BLOCK_LENGTH;
+        lane->full_blocks--;
+        return block;
+    }
+    return lane->tail + SHA256_BLOCK_LENGTH * lane->tail_used++;
+}
+
+static int sha256_lane_done(const SHA256_LANE* lane) {
+    return lane->full_blocks == 0 && lane->tail_used == lane->tail_blocks;
+}
+
+static void sha256_lane_finish(const uint32_t* state, size_t lanes, size_t slot, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    for (int k = 0; k < 8; k++) {
+        write_be32(digest + k * 4, state[k * lanes + slot]);
+    }
+}
+
+static void sha256_batch_run(sha256_lanes_fn transform, size_t lanes, const uint8_t* const* msgs, const size_t* lens, size_t n, uint8_t (*digests)[SHA256_DIGEST_LENGTH]) {
+    static const uint8_t idle_block[SHA256_BLOCK_LENGTH] = {0};
+    SHA256_LANE lane[SHA256_LANES_MAX];
+    uint32_t state[8 * SHA256_LANES_MAX];
+    const uint8_t* blocks[SHA256_LANES_MAX];
+    size_t next = 0, active = 0;
+
+    for (size_t i = 0; i < lanes; i++) {
+        if (next < n) {
+            sha256_lane_start(&lane[i], state, lanes, i, msgs[next], lens[next], next);
+            next++;
+            active++;
+        } else {
+            lane[i].index = SHA256_LANE_IDLE;
+        }
+    }
+
+    /* Keep every lane busy while there are messages to hand out; once the
+     * queue drains, finished lanes are masked out by feeding them a dummy
+     * block whose result is ignored. */
+    while (active > 1 || (active == 1 && lanes == 1)) {
+        for (size_t i = 0; i < lanes; i++) {
+            blocks[i] = (lane[i].index != SHA256_LANE_IDLE) ? sha256_lane_next(&lane[i]) : idle_block;
+        }
+        transform(state, blocks);
+        for (size_t i = 0; i < lanes; i++) {
+            if (lane[i].index == SHA256_LANE_IDLE || !sha256_lane_done(&lane[i])) {
+                continue;
+            }
+            sha256_lane_finish(state, lanes, i, digests[lane[i].index]);
+            if (next < n) {
+                sha256_lane_start(&lane[i], state, lanes, i, msgs[next], lens[next], next);
+                next++;
+            } else {
+                lane[i].index = SHA256_LANE_IDLE;
+                active--;
+            }
+        }
+    }
+
+    /* A single straggler is cheaper to finish on the scalar transform than
+     * by running a whole vector with one live lane. */
+    for (size_t i = 0; active > 0 && i < lanes; i++) {
+        if (lane[i].index == SHA256_LANE_IDLE) {
+            continue;
+        }
+        uint32_t single[8];
+        for (int k = 0; k < 8; k++) {
+            single[k] = state[k * lanes + i];
+        }
+        while (!sha256_lane_done(&lane[i])) {
+            const uint8_t* block = sha256_lane_next(&lane[i]);
+            sha256_transform_x1(single, &block);
+        }
+        sha256_lane_finish(single, 1, 0, digests[lane[i].index]);
+        memzero(single, sizeof(single));
+        active--;
+    }
+
+    memzero(lane, sizeof(lane));
+    memzero(state, sizeof(state));
+}
+
+static sha256_lanes_fn sha256_batch_engine(size_t* lanes) {
+    /* As in sha256_TransformMany: the SHA-NI and ARMv8 instructions beat
+     * the widest software lanes one message at a time. */
+    bool hardware = sha256_Backend() != SHA256_BACKEND_PORTABLE;
+#if defined(HELLO_SHA256_LANES_X86)
+    if (!hardware && cpu_features().avx2) {
+        *lanes = 8;
+        return sha256_transform_x8;
+    }
+    if (!hardware && cpu_features().sse2) {
+        *lanes = 4;
+        return sha256_transform_x4;
+    }
+#elif defined(HELLO_SHA256_LANES_4)
+    if (!hardware) {
+        *lanes = 4;
+        return sha256_transform_x4;
+    }
+#endif
+    *lanes = 1;
+    return sha256_transform_x1;
+}
+
+size_t sha256_BatchLanes(void) {
+    size_t lanes = 1;
+    sha256_batch_engine(&lanes);
+    return lanes;
+}
+
+void sha256_RawBatch(const uint8_t* const* msgs, const size_t* lens, size_t n, uint8_t (*digests)[SHA256_DIGEST_LENGTH]) {
+    size_t lanes = 1;
+    sha256_lanes_fn transform = sha256_batch_engine(&lanes);
+    if (lanes == 1) {
+        /* Nothing to interleave: hash each message straight through, so
+         * its full blocks go to the backend in one run. */
+        for (size_t i = 0; i < n; i++) {
+            sha256_Raw(msgs[i], lens[i], digests[i]);
+        }
+        return;
+    }
+    sha256_batch_run(transform, lanes, msgs, lens, n, digests);
+}
+
+void sha256_TransformMany(const uint32_t (*state_in)[8], const uint32_t (*data)[16], uint32_t (*state_out)[8], size_t n) {
+    size_t lanes = 1;
+    sha256_many_fn many = nullptr;
+    /* The SHA-NI and ARMv8 instructions already beat the widest software
+     * lanes one compression at a time. */
+    bool hardware = sha256_Backend() != SHA256_BACKEND_PORTABLE;
+#if defined(HELLO_SHA256_LANES_X86)
+    if (!hardware && cpu_features().avx2) {
+        lanes = 8;
+        many = sha256_many_x8;
+    } else if (!hardware && cpu_features().sse2) {
+        lanes = 4;
+        many = sha256_many_x4;
+    }
+#elif defined(HELLO_SHA256_LANES_4)
+    if (!hardware) {
+        lanes = 4;
+        many = sha256_many_x4;
+    }
+#endif
+
+    size_t i = 0;
+    for (; many != nullptr && i + lanes <= n; i += lanes) {
+        many(state_in + i, data + i, state_out + i);
+    }
+    /* A short tail of two or more jobs still runs as one vector, with the
+     * spare lanes repeating its last job. */
+    if (many != nullptr && n - i > 1) {
+        uint32_t tail_in[SHA256_LANES_MAX][8], tail_out[SHA256_LANES_MAX][8], tail_data[SHA256_LANES_MAX][16];
+        for (size_t lane = 0; lane < lanes; lane++) {
+            size_t k = (i + lane < n) ? i + lane : n - 1;
+            memcpy(tail_in[lane], state_in[k], sizeof(tail_in[lane]));
+            memcpy(tail_data[lane], data[k], sizeof(tail_data[lane]));
+        }
+        many(tail_in, tail_data, tail_out);
+        memcpy(state_out + i, tail_out, (n - i) * sizeof(tail_out[0]));
+        memzero(tail_in, sizeof(tail_in));
+        memzero(tail_out, sizeof(tail_out));
+        memzero(tail_data, sizeof(tail_data));
+        i = n;
+    }
+    for (; i < n; i++) {
+        sha256_Transform(state_in[i], data[i], state_out[i]);
+    }
+}
+
+} // namespace Hello
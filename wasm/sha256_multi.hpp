@@ -0,0 +1,31 @@
+#ifndef HELLO_SHA_256_MULTI_HPP
+#define HELLO_SHA_256_MULTI_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+// Number of messages the multi-buffer engine compresses side by side on this
+// CPU: 8 with AVX2, 4 with SSE2, NEON or WASM SIMD128, otherwise 1. It is
+// also 1 on a hardware SHA-256 backend (SHA-NI, ARMv8), which hashes one
+// message at a time faster than the software lanes.
+size_t sha256_BatchLanes(void);
+
+// Hashes n independent messages, writing SHA256(msgs[i][0..lens[i])) to
+// digests[i]. Messages are interleaved across SIMD lanes; a lane whose message
+// is finished is refilled with the next pending one, or masked out once none
+// are left.
+void sha256_RawBatch(const uint8_t* const* msgs, const size_t* lens, size_t n, uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+
+// Runs n independent compressions, state_out[i] = sha256_Transform(state_in[i],
+// data[i]), side by side on the same SIMD lanes. Blocks are host-order words
+// exactly as sha256_Transform takes them. state_out may alias state_in.
+void sha256_TransformMany(const uint32_t (*state_in)[8], const uint32_t (*data)[16], uint32_t (*state_out)[8], size_t n);
+
+} // namespace Hello
+
+#endif
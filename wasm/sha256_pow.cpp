@@ -0,0 +1,230 @@
+#include "sha256_pow.hpp"
+
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+
+#include "sha256_multi.hpp"
+#include "thread_pool.hpp"
+
+namespace Hello
+{
+
+#define SHA256_SHORT_BLOCK_LENGTH (SHA256_BLOCK_LENGTH - 8)
+
+/* Nonces compressed per sha256_TransformMany call: a whole number of the
+ * widest (8) software lanes. */
+#define SHA256_POW_GROUP 16
+
+/* No solution yet. The range ends below 2^64 - 1, so no nonce equals it. */
+#define SHA256_POW_NONE UINT64_MAX
+
+static inline uint32_t read_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void write_be32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t)(x >> 24);
+    p[1] = (uint8_t)(x >> 16);
+    p[2] = (uint8_t)(x >> 8);
+    p[3] = (uint8_t)x;
+}
+
+unsigned sha256_LeadingZeroBits(const uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    unsigned bits = 0;
+    for (size_t i = 0; i < SHA256_DIGEST_LENGTH; i++) {
+        if (digest[i] != 0) {
+            return bits + (unsigned)__builtin_clz(digest[i]) - 24;
+        }
+        bits += 8;
+    }
+    return bits;
+}
+
+bool sha256_PowCheck(const uint8_t* prefix, size_t len, uint64_t nonce, unsigned bits, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    uint8_t encoded[SHA256_POW_NONCE_LENGTH];
+    write_be32(encoded, (uint32_t)(nonce >> 32));
+    write_be32(encoded + 4, (uint32_t)nonce);
+    uint8_t hash[SHA256_DIGEST_LENGTH];
+    SHA256_CTX ctx;
+    sha256_Init(&ctx);
+    sha256_Update(&ctx, prefix, len);
+    sha256_Update(&ctx, encoded, sizeof(encoded));
+    sha256_Final(&ctx, hash);
+    if (digest != nullptr) {
+        memcpy(digest, hash, SHA256_DIGEST_LENGTH);
+    }
+    return bits <= SHA256_POW_MAX_BITS && sha256_LeadingZeroBits(hash) >= bits;
+}
+
+/*** FINAL BLOCKS *****************************************************/
+/*
+ * What is left to compress after the prefix: the prefix bytes still in the
+ * context buffer, the nonce, 0x80, zeros and the bit length, in one block
+ * or, when the nonce and the length do not fit together, two. The nonce
+ * starts at byte `used`; read as a 96-bit big-endian window over the three
+ * words from used / 4 on, it is the nonce shifted left by 32 - 8 * (used %
+ * 4) bits, so patching a nonce in takes three word writes.
+ */
+struct PowTail {
+    uint32_t state[8];
+    uint32_t words[2 * 16]; // nonce bytes zero
+    size_t blocks;
+    size_t word;            // first word with nonce bytes
+    unsigned shift;         // 8 * (used % 4)
+};
+
+static void pow_tail(const uint8_t* prefix, size_t len, PowTail* tail) {
+    SHA256_CTX ctx;
+    sha256_Init(&ctx);
+    sha256_Update(&ctx, prefix, len);
+    size_t used = (size_t)(ctx.bitcount >> 3) % SHA256_BLOCK_LENGTH;
+
+    uint8_t bytes[2 * SHA256_BLOCK_LENGTH] = {0};
+    memcpy(bytes, ctx.buffer, used);
+    bytes[used + SHA256_POW_NONCE_LENGTH] = 0x80;
+    tail->blocks = (used + SHA256_POW_NONCE_LENGTH < SHA256_SHORT_BLOCK_LENGTH) ? 1 : 2;
+    uint64_t bitcount = ((uint64_t)len + SHA256_POW_NONCE_LENGTH) << 3;
+    uint8_t* end = bytes + tail->blocks * SHA256_BLOCK_LENGTH;
+    write_be32(end - 8, (uint32_t)(bitcount >> 32));
+    write_be32(end - 4, (uint32_t)bitcount);
+
+    for (size_t i = 0; i < 2 * 16; i++) {
+        tail->words[i] = read_be32(bytes + i * 4);
+    }
+    memcpy(tail->state, ctx.state, sizeof(tail->state));
+    tail->word = used / 4;
+    tail->shift = 8 * (unsigned)(used % 4);
+}
+
+/* Whether a final state starts with `bits` zero bits. The first word
+ * settles nearly every nonce. */
+static inline bool pow_meets(const uint32_t state[8], unsigned bits) {
+    size_t i = 0;
+    for (; bits >= 32; i++, bits -= 32) {
+        if (state[i] != 0) {
+            return false;
+        }
+    }
+    return bits == 0 || (state[i] >> (32 - bits)) == 0;
+}
+
+/*** SEARCH ***********************************************************/
+struct PowSearch {
+    const PowTail* tail;
+    unsigned bits;
+    uint64_t start;
+    uint64_t end;
+    uint64_t chunks;
+    std::atomic<uint64_t> next_chunk;
+    std::atomic<uint64_t> best; // smallest solution so far
+    std::atomic<uint64_t> hashes;
+};
+
+static void pow_found(PowSearch& search, uint64_t nonce) {
+    uint64_t best = search.best.load(std::memory_order_relaxed);
+    while (nonce < best && !search.best.compare_exchange_weak(best, nonce, std::memory_order_relaxed)) {
+    }
+}
+
+/* Claims chunks in increasing order until the range runs out or a
+ * solution below the next chunk is known. */
+static void pow_worker(PowSearch& search) {
+    const PowTail& tail = *search.tail;
+    uint32_t states[SHA256_POW_GROUP][8];
+    uint32_t blocks[2][SHA256_POW_GROUP][16];
+    for (size_t g = 0; g < SHA256_POW_GROUP; g++) {
+        memcpy(blocks[0][g], tail.words, sizeof(blocks[0][g]));
+        memcpy(blocks[1][g], tail.words + 16, sizeof(blocks[1][g]));
+    }
+    auto word = [&](size_t g, size_t w) -> uint32_t& { return blocks[w / 16][g][w % 16]; };
+
+    uint64_t hashed = 0;
+    for (;;) {
+        uint64_t chunk = search.next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= search.chunks) {
+            break;
+        }
+        uint64_t from = search.start + chunk * SHA256_POW_CHUNK;
+        uint64_t to = (search.end - from < SHA256_POW_CHUNK) ? search.end : from + SHA256_POW_CHUNK;
+        if (from > search.best.load(std::memory_order_relaxed)) {
+            break;
+        }
+        for (uint64_t nonce = from; nonce < to;) {
+            /* Cooperative cancellation: stop once a smaller solution is in. */
+            if (nonce > search.best.load(std::memory_order_relaxed)) {
+                break;
+            }
+            size_t n = (to - nonce < SHA256_POW_GROUP) ? (size_t)(to - nonce) : SHA256_POW_GROUP;
+            for (size_t g = 0; g < n; g++) {
+                uint64_t x = nonce + g;
+                word(g, tail.word) = tail.words[tail.word] | (uint32_t)(x >> (32 + tail.shift));
+                word(g, tail.word + 1) = (uint32_t)(x >> tail.shift);
+                if (tail.shift != 0) {
+                    word(g, tail.word + 2) = tail.words[tail.word + 2] | (uint32_t)(x << (32 - tail.shift));
+                }
+                memcpy(states[g], tail.state, sizeof(states[g]));
+            }
+            sha256_TransformMany(states, blocks[0], states, n);
+            if (tail.blocks == 2) {
+                sha256_TransformMany(states, blocks[1], states, n);
+            }
+            hashed += n;
+            for (size_t g = 0; g < n; g++) {
+                if (pow_meets(states[g], search.bits)) {
+                    pow_found(search, nonce + g);
+                    break;
+                }
+            }
+            nonce += n;
+        }
+    }
+    search.hashes.fetch_add(hashed, std::memory_order_relaxed);
+}
+
+bool sha256_PowSearch(const uint8_t* prefix, size_t len, unsigned bits, uint64_t start, uint64_t count, Sha256PowResult* result,
+                      ThreadPool* pool) {
+    memset(result, 0, sizeof(*result));
+    uint64_t end = (count > SHA256_POW_NONE - start) ? SHA256_POW_NONE : start + count;
+    if (bits > SHA256_POW_MAX_BITS || end == start) {
+        return false;
+    }
+    if (pool == nullptr) {
+        pool = &ThreadPool::shared();
+    }
+    auto began = std::chrono::steady_clock::now();
+
+    PowTail tail;
+    pow_tail(prefix, len, &tail);
+    PowSearch search;
+    search.tail = &tail;
+    search.bits = bits;
+    search.start = start;
+    search.end = end;
+    search.chunks = (end - start - 1) / SHA256_POW_CHUNK + 1;
+    search.next_chunk = 0;
+    search.best = SHA256_POW_NONE;
+    search.hashes = 0;
+
+    /* One task per worker, each claiming chunks; the caller runs tasks
+     * too, so a pool without workers searches inline. */
+    size_t tasks = pool->size() ? pool->size() : 1;
+    if ((uint64_t)tasks > search.chunks) {
+        tasks = (size_t)search.chunks;
+    }
+    pool->parallel_for(tasks, [&](size_t) { pow_worker(search); });
+
+    result->hashes = search.hashes.load();
+    result->threads = (uint32_t)tasks;
+    result->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+    uint64_t best = search.best.load();
+    if (best == SHA256_POW_NONE) {
+        return false;
+    }
+    result->nonce = best;
+    result->found = sha256_PowCheck(prefix, len, best, bits, result->digest);
+    return result->found != 0;
+}
+
+} // namespace Hello
@@ -0,0 +1,65 @@
+#ifndef HELLO_SHA_256_POW_HPP
+#define HELLO_SHA_256_POW_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+class ThreadPool;
+
+/*** PROOF OF WORK ****************************************************/
+/*
+ * Hashcash-style proof of work: a nonce solves a challenge prefix at a
+ * difficulty of `bits` when
+ *
+ *   SHA256(prefix || u64 nonce)
+ *
+ * (the nonce big-endian) starts with at least `bits` zero bits. Checking a
+ * solution costs one hash; finding one costs 2^bits on average.
+ *
+ * The search absorbs the prefix once and compresses only the one or two
+ * final blocks per nonce, patching the nonce words into a prepared block
+ * and running nonces side by side through sha256_TransformMany. A digest
+ * is only written out for a nonce whose first state word already passes.
+ */
+#define SHA256_POW_NONCE_LENGTH 8
+#define SHA256_POW_MAX_BITS 256
+
+// Nonces a worker claims at a time.
+#define SHA256_POW_CHUNK 4096
+
+// Result of a search; the layout is fixed because JS reads it from the
+// heap.
+struct Sha256PowResult {
+    uint64_t nonce;   // the solution, when found
+    uint64_t hashes;  // nonces hashed by all threads together
+    double seconds;   // wall time of the search
+    uint32_t found;   // 1 if nonce solves the challenge
+    uint32_t threads; // workers the range was split across
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+};
+
+// Number of leading zero bits of a digest.
+unsigned sha256_LeadingZeroBits(const uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// Whether nonce solves prefix at bits. digest, if non-null, receives
+// SHA256(prefix || nonce) either way.
+bool sha256_PowCheck(const uint8_t* prefix, size_t len, uint64_t nonce, unsigned bits,
+                     uint8_t digest[SHA256_DIGEST_LENGTH] = nullptr);
+
+// Looks for the smallest nonce in [start, start + count) (clamped below
+// 2^64 - 1) that solves prefix at bits, splitting the range across pool
+// (the shared pool when null) in chunks of SHA256_POW_CHUNK. Once a
+// solution is found, workers drop every nonce above it, so the answer is
+// the same for any number of threads. Returns false, with result->found 0,
+// if no nonce in the range solves it or bits exceeds SHA256_POW_MAX_BITS.
+bool sha256_PowSearch(const uint8_t* prefix, size_t len, unsigned bits, uint64_t start, uint64_t count, Sha256PowResult* result,
+                      ThreadPool* pool = nullptr);
+
+} // namespace Hello
+
+#endif
@@ -0,0 +1,134 @@
+#include "sha256_tree.hpp"
+
+#include <string.h>
+
+#include <vector>
+
+#include "memzero.hpp"
+#include "sha256_multi.hpp"
+#include "thread_pool.hpp"
+
+namespace Hello
+{
+
+#define SHA256_TREE_LEAF 0x00
+#define SHA256_TREE_NODE 0x01
+#define SHA256_TREE_ROOT 0x02
+
+static void write_be64(uint8_t* p, uint64_t x) {
+    for (int i = 7; i >= 0; i--) {
+        p[i] = (uint8_t)x;
+        x >>= 8;
+    }
+}
+
+size_t sha256_TreeLeafCount(uint64_t total_len, size_t leaf_size) {
+    if (leaf_size == 0) {
+        return 0;
+    }
+    if (total_len == 0) {
+        return 1;
+    }
+    return (size_t)((total_len + leaf_size - 1) / leaf_size);
+}
+
+void sha256_TreeLeaf(const uint8_t* leaf, size_t len, uint64_t index, uint8_t digest[SHA256_DIGEST_LENGTH]) {
+    uint8_t prefix[9];
+    prefix[0] = SHA256_TREE_LEAF;
+    write_be64(prefix + 1, index);
+
+    SHA256_CTX context;
+    sha256_Init(&context);
+    sha256_Update(&context, prefix, sizeof(prefix));
+    sha256_Update(&context, leaf, len);
+    sha256_Final(&context, digest);
+}
+
+void sha256_TreeRoot(const uint8_t (*leaves)[SHA256_DIGEST_LENGTH], size_t leaf_count, uint64_t total_len, size_t leaf_size,
+                     uint8_t root[SHA256_DIGEST_LENGTH]) {
+    std::vector<uint8_t> level((const uint8_t*)leaves, (const uint8_t*)(leaves + leaf_count));
+    std::vector<uint8_t> nodes;
+    std::vector<const uint8_t*> msgs;
+    std::vector<size_t> lens;
+
+    /* Each level is one multi-buffer batch of 65-byte node messages. */
+    while (leaf_count > 1) {
+        size_t pairs = leaf_count / 2;
+        nodes.resize(pairs * (1 + 2 * SHA256_DIGEST_LENGTH));
+        msgs.resize(pairs);
+        lens.assign(pairs, 1 + 2 * SHA256_DIGEST_LENGTH);
+        for (size_t i = 0; i < pairs; i++) {
+            uint8_t* node = &nodes[i * (1 + 2 * SHA256_DIGEST_LENGTH)];
+            node[0] = SHA256_TREE_NODE;
+            memcpy(node + 1, &level[i * 2 * SHA256_DIGEST_LENGTH], 2 * SHA256_DIGEST_LENGTH);
+            msgs[i] = node;
+        }
+        sha256_RawBatch(msgs.data(), lens.data(), pairs, (uint8_t (*)[SHA256_DIGEST_LENGTH])level.data());
+        if (leaf_count % 2) {
+            memmove(&level[pairs * SHA256_DIGEST_LENGTH], &level[(leaf_count - 1) * SHA256_DIGEST_LENGTH], SHA256_DIGEST_LENGTH);
+        }
+        leaf_count = pairs + leaf_count % 2;
+    }
+
+    uint8_t message[1 + 8 + 8 + SHA256_DIGEST_LENGTH];
+    message[0] = SHA256_TREE_ROOT;
+    write_be64(message + 1, total_len);
+    write_be64(message + 9, leaf_size);
+    memcpy(message + 17, level.data(), SHA256_DIGEST_LENGTH);
+    sha256_Raw(message, sizeof(message), root);
+}
+
+bool sha256_Tree(const uint8_t* data, size_t len, size_t leaf_size, uint8_t root[SHA256_DIGEST_LENGTH],
+                 uint8_t (*leaves)[SHA256_DIGEST_LENGTH], ThreadPool* pool) {
+    if (leaf_size == 0) {
+        return false;
+    }
+    size_t count = sha256_TreeLeafCount(len, leaf_size);
+    std::vector<uint8_t> storage;
+    if (leaves == nullptr) {
+        storage.resize(count * SHA256_DIGEST_LENGTH);
+        leaves = (uint8_t (*)[SHA256_DIGEST_LENGTH])storage.data();
+    }
+    if (pool == nullptr) {
+        pool = &ThreadPool::shared();
+    }
+
+    pool->parallel_for(count, [&](size_t i) {
+        size_t offset = i * leaf_size;
+        size_t n = (len - offset < leaf_size) ? len - offset : leaf_size;
+        sha256_TreeLeaf(data + offset, n, i, leaves[i]);
+    });
+
+    sha256_TreeRoot(leaves, count, len, leaf_size, root);
+    return true;
+}
+
+bool sha256_TreeVerifyRange(const uint8_t* data, uint64_t total_len, size_t leaf_size, uint64_t offset, uint64_t len,
+                            const uint8_t (*leaves)[SHA256_DIGEST_LENGTH], const uint8_t root[SHA256_DIGEST_LENGTH]) {
+    if (leaf_size == 0 || offset > total_len || len > total_len - offset) {
+        return false;
+    }
+    size_t count = sha256_TreeLeafCount(total_len, leaf_size);
+    size_t first = (size_t)(offset / leaf_size);
+    size_t last = (len == 0) ? first : (size_t)((offset + len - 1) / leaf_size);
+    if (last >= count) {
+        last = count - 1;
+    }
+
+    bool ok = true;
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    for (size_t i = first; i <= last && ok; i++) {
+        uint64_t start = (uint64_t)i * leaf_size;
+        size_t n = (total_len - start < leaf_size) ? (size_t)(total_len - start) : leaf_size;
+        sha256_TreeLeaf(data + start, n, i, digest);
+        ok = memcmp(digest, leaves[i], SHA256_DIGEST_LENGTH) == 0;
+    }
+    if (ok && root != nullptr) {
+        sha256_TreeRoot(leaves, count, total_len, leaf_size, digest);
+        ok = memcmp(digest, root, SHA256_DIGEST_LENGTH) == 0;
+    }
+    memzero(digest, sizeof(digest));
+    return ok;
+}
+
+} // namespace Hello
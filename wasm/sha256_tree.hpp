@@ -0,0 +1,59 @@
+#ifndef HELLO_SHA_256_TREE_HPP
+#define HELLO_SHA_256_TREE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sha256.hpp"
+
+namespace Hello
+{
+
+class ThreadPool;
+
+/*** TREE HASH FORMAT *************************************************/
+/*
+ * The input is cut into leaves of leaf_size bytes (the last one may be
+ * shorter; an empty input has one empty leaf). Integers are big-endian and
+ * every hash is domain-separated by its first byte:
+ *
+ *   leaf i       L[i] = SHA256(0x00 || u64 i || bytes of leaf i)
+ *   inner node   N    = SHA256(0x01 || left || right)
+ *   root              = SHA256(0x02 || u64 total_len || u64 leaf_size || top)
+ *
+ * Levels are built pairwise from the left; an unpaired node at the end of a
+ * level moves up unchanged. "top" is the single node left at the end. The
+ * root therefore differs from a plain SHA256 of the same bytes, and from a
+ * tree with a different leaf size.
+ */
+#define SHA256_TREE_DEFAULT_LEAF_SIZE (1024 * 1024)
+
+// Number of leaves an input of total_len bytes is split into, or 0 if
+// leaf_size is 0.
+size_t sha256_TreeLeafCount(uint64_t total_len, size_t leaf_size);
+
+// Tree-hashes data, hashing leaves concurrently on pool (the shared pool
+// when null). If leaves is non-null it receives every leaf digest, which is
+// what sha256_TreeVerifyRange checks against later. Returns false, writing
+// nothing, if leaf_size is 0.
+bool sha256_Tree(const uint8_t* data, size_t len, size_t leaf_size, uint8_t root[SHA256_DIGEST_LENGTH],
+                 uint8_t (*leaves)[SHA256_DIGEST_LENGTH] = nullptr, ThreadPool* pool = nullptr);
+
+// Computes the root from stored leaf digests alone.
+void sha256_TreeRoot(const uint8_t (*leaves)[SHA256_DIGEST_LENGTH], size_t leaf_count, uint64_t total_len, size_t leaf_size,
+                     uint8_t root[SHA256_DIGEST_LENGTH]);
+
+// Digest of leaf `index` holding `len` bytes.
+void sha256_TreeLeaf(const uint8_t* leaf, size_t len, uint64_t index, uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+// Rechecks the bytes [offset, offset + len) of an input previously hashed
+// with sha256_Tree, rehashing only the leaves that overlap the range. data
+// points at the start of the whole input (e.g. an mmap), but only the
+// covering leaves are read. When root is non-null the stored leaf digests
+// are also checked against it. A leaf_size of 0 never verifies.
+bool sha256_TreeVerifyRange(const uint8_t* data, uint64_t total_len, size_t leaf_size, uint64_t offset, uint64_t len,
+                            const uint8_t (*leaves)[SHA256_DIGEST_LENGTH], const uint8_t root[SHA256_DIGEST_LENGTH] = nullptr);
+
+} // namespace Hello
+
+#endif
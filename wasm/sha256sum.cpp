@@ -0,0 +1,80 @@
+// Native sha256sum: prints "<digest>  <path>" for every path argument, or
+// for stdin when there are none. Files are hashed concurrently; -j sets the
+// number of worker threads.
+//
+//   sha256sum [-j threads] [path ...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "hex.hpp"
+#include "sha256_file.hpp"
+#include "thread_pool.hpp"
+
+using namespace Hello;
+
+// Paths are hashed and printed in batches so output keeps flowing and
+// memory stays flat however many paths are given.
+#define SHA256SUM_BATCH 1024
+
+static int usage() {
+    fprintf(stderr, "usage: sha256sum [-j threads] [path ...]\n");
+    return 2;
+}
+
+static bool print_batch(const std::vector<std::string>& paths, ThreadPool& pool) {
+    bool ok = true;
+    char hex[SHA256_DIGEST_LENGTH * 2];
+    for (const FileDigest& result : sha256_files(paths, &pool)) {
+        if (result.error != 0) {
+            fprintf(stderr, "sha256sum: %s: %s\n", result.path.c_str(), strerror(result.error));
+            ok = false;
+            continue;
+        }
+        data_to_hex(result.digest, SHA256_DIGEST_LENGTH, hex);
+        printf("%.*s  %s\n", (int)sizeof(hex), hex, result.path.c_str());
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    size_t threads = 0;
+    int first = 1;
+    while (first < argc && argv[first][0] == '-' && argv[first][1] != 0) {
+        if (strcmp(argv[first], "--") == 0) {
+            first++;
+            break;
+        } else if (strcmp(argv[first], "-j") == 0 && first + 1 < argc) {
+            char* end;
+            threads = strtoul(argv[first + 1], &end, 10);
+            if (*end != 0 || threads == 0) {
+                return usage();
+            }
+            first += 2;
+        } else {
+            return usage();
+        }
+    }
+
+    ThreadPool pool(threads);
+    std::vector<std::string> paths;
+    if (first == argc) {
+        paths.push_back("-");
+    }
+
+    bool ok = true;
+    for (int i = first; i <= argc; i++) {
+        if (i < argc) {
+            paths.push_back(argv[i]);
+        }
+        if (paths.size() == SHA256SUM_BATCH || (i == argc && !paths.empty())) {
+            ok = print_batch(paths, pool) && ok;
+            paths.clear();
+        }
+    }
+    return ok ? 0 : 1;
+}
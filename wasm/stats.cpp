@@ -0,0 +1,168 @@
+#include "stats.hpp"
+
+#ifdef HELLO_STATS
+#include <atomic>
+#include <new>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#define malloc_usable_size malloc_size
+#else
+#include <malloc.h>
+#endif
+#ifdef __EMSCRIPTEN__
+#include <unistd.h>
+#endif
+#endif
+
+namespace Hello
+{
+
+const char* stats_name(HELLO_STAT stat) {
+    static const char* names[HELLO_STAT_COUNT] = {
+        "scratch_alloc",
+        "reverse",
+        "sha256",
+        "sha256d",
+        "sha256_update",
+        "sha256_resume",
+        "sha256_prefixed",
+        "sha256_batch",
+        "sha256_tree",
+        "hmac_sha256",
+        "hmac_sha256_update",
+        "pbkdf2_hmac_sha256",
+        "data_to_hex",
+        "hex_to_data",
+        "chunker_update",
+        "typed_array",
+        "sha256_pow_search",
+    };
+    return (unsigned)stat < HELLO_STAT_COUNT ? names[stat] : nullptr;
+}
+
+#ifdef HELLO_STATS
+
+// Relaxed atomics: each counter is exact, but a snapshot taken while other
+// threads count is not one consistent instant.
+static std::atomic<uint64_t> stat_counters[HELLO_STAT_COUNT][3];
+static std::atomic<uint64_t> stat_mallocs;
+static std::atomic<uint64_t> stat_frees;
+static std::atomic<uint64_t> stat_heap_bytes;
+static std::atomic<uint64_t> stat_heap_peak;
+static std::atomic<uint64_t> stat_heap_top;
+
+static void stats_raise(std::atomic<uint64_t>& mark, uint64_t value) {
+    uint64_t seen = mark.load(std::memory_order_relaxed);
+    while(value > seen && !mark.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+static void stats_sample_heap_top() {
+#ifdef __EMSCRIPTEN__
+    stats_raise(stat_heap_top, (uintptr_t)sbrk(0));
+#endif
+}
+
+void stats_record(HELLO_STAT stat, uint64_t bytes, uint64_t ns) {
+    stat_counters[stat][0].fetch_add(1, std::memory_order_relaxed);
+    stat_counters[stat][1].fetch_add(bytes, std::memory_order_relaxed);
+    stat_counters[stat][2].fetch_add(ns, std::memory_order_relaxed);
+}
+
+void* stats_malloc(size_t size) {
+    void* p = malloc(size);
+    if(p) {
+        size_t usable = malloc_usable_size(p);
+        uint64_t bytes = stat_heap_bytes.fetch_add(usable, std::memory_order_relaxed) + usable;
+        stat_mallocs.fetch_add(1, std::memory_order_relaxed);
+        stats_raise(stat_heap_peak, bytes);
+        stats_sample_heap_top();
+    }
+    return p;
+}
+
+void stats_free(void* p) {
+    if(p) {
+        stat_heap_bytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+        stat_frees.fetch_add(1, std::memory_order_relaxed);
+        free(p);
+    }
+}
+
+const Stats* stats_snapshot() {
+    static Stats snapshot;
+    stats_sample_heap_top();
+    snapshot.version = HELLO_STATS_VERSION;
+    snapshot.count = HELLO_STAT_COUNT;
+    snapshot.mallocs = stat_mallocs.load(std::memory_order_relaxed);
+    snapshot.frees = stat_frees.load(std::memory_order_relaxed);
+    snapshot.heap_bytes = stat_heap_bytes.load(std::memory_order_relaxed);
+    snapshot.heap_peak = stat_heap_peak.load(std::memory_order_relaxed);
+    snapshot.heap_top = stat_heap_top.load(std::memory_order_relaxed);
+    for(int i = 0; i < HELLO_STAT_COUNT; i++) {
+        snapshot.exports[i].calls = stat_counters[i][0].load(std::memory_order_relaxed);
+        snapshot.exports[i].bytes = stat_counters[i][1].load(std::memory_order_relaxed);
+        snapshot.exports[i].ns = stat_counters[i][2].load(std::memory_order_relaxed);
+    }
+    return &snapshot;
+}
+
+void stats_reset() {
+    for(auto& counters : stat_counters) {
+        for(auto& counter : counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+    stat_mallocs.store(0, std::memory_order_relaxed);
+    stat_frees.store(0, std::memory_order_relaxed);
+    stat_heap_peak.store(stat_heap_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    stat_heap_top.store(0, std::memory_order_relaxed);
+    stats_sample_heap_top();
+}
+
+#else
+
+const Stats* stats_snapshot() {
+    return nullptr;
+}
+
+void stats_reset() {
+}
+
+#endif
+
+} // namespace Hello
+
+#ifdef HELLO_STATS
+
+// C++ allocations (vectors in the batch paths, the prefix cache, the thread
+// pool) are counted along with the module's own mallocs.
+void* operator new(size_t size) {
+    void* p = Hello::stats_malloc(size ? size : 1);
+    if(!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    Hello::stats_free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    Hello::stats_free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    Hello::stats_free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    Hello::stats_free(p);
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef HELLO_STATS_HPP
+#define HELLO_STATS_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef HELLO_STATS
+#include <chrono>
+#endif
+
+namespace Hello
+{
+
+// Hot-path counters, compiled in with -DHELLO_STATS (HELLO_STATS=1 in
+// build.sh). Without it HELLO_STATS_SCOPE expands to nothing, the
+// allocation helpers are plain malloc/free and stats_snapshot() returns
+// null, so an uninstrumented build pays nothing.
+
+#define HELLO_STATS_VERSION 1
+
+// One counter set per instrumented export. Keep stats_name() in step.
+enum HELLO_STAT {
+    HELLO_STAT_SCRATCH_ALLOC,
+    HELLO_STAT_REVERSE,
+    HELLO_STAT_SHA256,
+    HELLO_STAT_SHA256D,
+    HELLO_STAT_SHA256_UPDATE,
+    HELLO_STAT_SHA256_RESUME,
+    HELLO_STAT_SHA256_PREFIXED,
+    HELLO_STAT_SHA256_BATCH,
+    HELLO_STAT_SHA256_TREE,
+    HELLO_STAT_HMAC_SHA256,
+    HELLO_STAT_HMAC_SHA256_UPDATE,
+    HELLO_STAT_PBKDF2_HMAC_SHA256,
+    HELLO_STAT_DATA_TO_HEX,
+    HELLO_STAT_HEX_TO_DATA,
+    HELLO_STAT_CHUNKER_UPDATE,
+    HELLO_STAT_TYPED_ARRAY,
+    HELLO_STAT_SHA256_POW_SEARCH,
+    HELLO_STAT_COUNT
+};
+
+struct StatCounter {
+    uint64_t calls;
+    uint64_t bytes; // input bytes; scratch_alloc counts bytes handed out
+    uint64_t ns;    // wall time inside the export
+};
+
+// Layout read by Module.stats() in hello.post.js: all fields are 64-bit
+// except the two leading 32-bit ones.
+struct Stats {
+    uint32_t version;     // HELLO_STATS_VERSION
+    uint32_t count;       // HELLO_STAT_COUNT
+    uint64_t mallocs;     // module allocations, including C++ new
+    uint64_t frees;
+    uint64_t heap_bytes;  // currently allocated by the above
+    uint64_t heap_peak;   // high-water mark of heap_bytes
+    uint64_t heap_top;    // wasm: highest sbrk break seen; native: 0
+    StatCounter exports[HELLO_STAT_COUNT];
+};
+
+// Name of the export counted by stat, e.g. "sha256".
+const char* stats_name(HELLO_STAT stat);
+
+// Copies the counters into a static Stats and returns it, or returns null
+// when instrumentation is compiled out. The copy is only consistent per
+// field while other threads are still counting.
+const Stats* stats_snapshot();
+
+// Zeroes every counter except heap_bytes, which tracks live allocations;
+// heap_peak restarts from it.
+void stats_reset();
+
+#ifdef HELLO_STATS
+
+void stats_record(HELLO_STAT stat, uint64_t bytes, uint64_t ns);
+void* stats_malloc(size_t size);
+void stats_free(void* p);
+
+// Sum of lens[0..n), the byte count of a batch export.
+inline uint64_t stats_total(const size_t* lens, size_t n) {
+    uint64_t total = 0;
+    for(size_t i = 0; i < n; i++) {
+        total += lens[i];
+    }
+    return total;
+}
+
+// Counts one call of an export and the time until the end of the scope.
+class StatsScope {
+public:
+    StatsScope(HELLO_STAT stat, uint64_t bytes) : stat_(stat), bytes_(bytes), start_(std::chrono::steady_clock::now()) {
+    }
+    ~StatsScope() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        stats_record(stat_, bytes_, (uint64_t)ns);
+    }
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+private:
+    HELLO_STAT stat_;
+    uint64_t bytes_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define HELLO_STATS_SCOPE(stat, bytes) Hello::StatsScope hello_stats_scope_(stat, bytes)
+
+#else
+
+#define HELLO_STATS_SCOPE(stat, bytes) ((void)0)
+
+inline void* stats_malloc(size_t size) {
+    return ::malloc(size);
+}
+
+inline void stats_free(void* p) {
+    ::free(p);
+}
+
+#endif
+
+} // namespace Hello
+
+#endif
@@ -0,0 +1,235 @@
+#include "sverdle.hpp"
+
+#if defined(__unix__) && !defined(__EMSCRIPTEN__)
+#define HELLO_HAVE_MMAP 1
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Hello
+{
+
+/* The table generated into sverdle_words.cpp by sverdle.words.mjs. */
+extern const size_t sverdle_words_size;
+extern const uint32_t sverdle_words_blob[];
+
+/* Section pointers of the table in use. */
+struct SverdleWords {
+    const uint32_t* words;
+    const uint16_t* seeds;
+    const uint16_t* slots;
+    const uint32_t* answer_bits;
+    const uint16_t* answers;
+    size_t word_count;
+    size_t answer_count;
+    size_t bucket_count;
+    size_t slot_count;
+    size_t size;
+};
+
+/* Fills words from a blob; false if it is not a well-formed table. Only
+ * bounds are checked, in O(slots + answers): a table with unsorted words or
+ * a wrong hash gives wrong answers but never reads outside the blob. */
+static bool sverdle_View(const void* data, size_t size, SverdleWords* words) {
+    const SverdleWordsHeader* header = (const SverdleWordsHeader*)data;
+    if (((uintptr_t)data & 3) != 0 || size < sizeof(*header) || header->magic != SVERDLE_WORDS_MAGIC ||
+        header->version != SVERDLE_WORDS_VERSION || header->size > size || header->word_count == 0 ||
+        header->word_count > 0xffff || header->bucket_count == 0 || header->slot_count == 0) {
+        return false;
+    }
+    const struct {
+        uint32_t offset;
+        size_t bytes;
+    } sections[] = {
+        {header->words_offset, (size_t)header->word_count * 4},
+        {header->seeds_offset, (size_t)header->bucket_count * 2},
+        {header->slots_offset, (size_t)header->slot_count * 2},
+        {header->answer_bits_offset, ((size_t)header->word_count + 31) / 32 * 4},
+        {header->answers_offset, (size_t)header->answer_count * 2},
+    };
+    for (const auto& section : sections) {
+        if ((section.offset & 3) != 0 || section.offset > header->size || section.bytes > header->size - section.offset) {
+            return false;
+        }
+    }
+
+    const uint8_t* base = (const uint8_t*)data;
+    const uint16_t* slots = (const uint16_t*)(base + header->slots_offset);
+    const uint16_t* answers = (const uint16_t*)(base + header->answers_offset);
+    for (size_t i = 0; i < header->slot_count; i++) {
+        if (slots[i] >= header->word_count) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < header->answer_count; i++) {
+        if (answers[i] >= header->word_count) {
+            return false;
+        }
+    }
+
+    words->words = (const uint32_t*)(base + header->words_offset);
+    words->seeds = (const uint16_t*)(base + header->seeds_offset);
+    words->slots = slots;
+    words->answer_bits = (const uint32_t*)(base + header->answer_bits_offset);
+    words->answers = answers;
+    words->word_count = header->word_count;
+    words->answer_count = header->answer_count;
+    words->bucket_count = header->bucket_count;
+    words->slot_count = header->slot_count;
+    words->size = header->size;
+    return true;
+}
+
+static SverdleWords embedded_words() {
+    SverdleWords words = {};
+    sverdle_View(sverdle_words_blob, sverdle_words_size, &words);
+    return words;
+}
+
+/* The generated blob is constant-initialized, so it is readable from this
+ * dynamic initializer whatever the link order. */
+static SverdleWords table = embedded_words();
+
+/* Keep in step with hash and reduce in sverdle.words.mjs. */
+static inline uint32_t sverdle_hash(uint32_t key, uint32_t seed) {
+    uint32_t x = key ^ seed;
+    x = (x ^ (x >> 16)) * 0x7feb352du;
+    x = (x ^ (x >> 15)) * 0x846ca68bu;
+    return x ^ (x >> 16);
+}
+
+/* Maps a 32-bit hash onto [0, n) without a division. */
+static inline size_t reduce(uint32_t h, size_t n) {
+    return (size_t)(((uint64_t)h * n) >> 32);
+}
+
+static const uint8_t powers_of_3[SVERDLE_LETTERS] = {1, 3, 9, 27, 81};
+
+uint32_t sverdle_Pack(const char* letters, size_t len) {
+    if (len != SVERDLE_LETTERS) {
+        return SVERDLE_INVALID;
+    }
+    uint32_t word = 0;
+    for (int i = SVERDLE_LETTERS - 1; i >= 0; i--) {
+        uint32_t letter = (uint8_t)letters[i] - (uint32_t)'a';
+        if (letter > 25) {
+            return SVERDLE_INVALID;
+        }
+        word = (word << 5) | letter;
+    }
+    return word;
+}
+
+void sverdle_Unpack(uint32_t word, char letters[SVERDLE_LETTERS]) {
+    for (int i = 0; i < SVERDLE_LETTERS; i++) {
+        letters[i] = (char)('a' + ((word >> (5 * i)) & 31));
+    }
+}
+
+size_t sverdle_AnswerCount() {
+    return table.answer_count;
+}
+
+uint32_t sverdle_Answer(size_t index) {
+    return index < table.answer_count ? table.words[table.answers[index]] : SVERDLE_INVALID;
+}
+
+size_t sverdle_GuessIndex(uint32_t word) {
+    size_t bucket = reduce(sverdle_hash(word, 0), table.bucket_count);
+    size_t slot = reduce(sverdle_hash(word, table.seeds[bucket]), table.slot_count);
+    size_t index = table.slots[slot];
+    return table.words[index] == word ? index : SVERDLE_NO_INDEX;
+}
+
+bool sverdle_Allowed(uint32_t word) {
+    return sverdle_GuessIndex(word) != SVERDLE_NO_INDEX;
+}
+
+bool sverdle_IsAnswer(uint32_t word) {
+    size_t index = sverdle_GuessIndex(word);
+    return index != SVERDLE_NO_INDEX && ((table.answer_bits[index / 32] >> (index % 32)) & 1);
+}
+
+size_t sverdle_GuessCount() {
+    return table.word_count;
+}
+
+uint32_t sverdle_Guess(size_t index) {
+    return index < table.word_count ? table.words[index] : SVERDLE_INVALID;
+}
+
+uint8_t sverdle_Score(uint32_t guess, uint32_t answer) {
+    /* Pass 1: exact matches, and a count of every answer letter they left. */
+    uint8_t left[32] = {0};
+    uint32_t exact = 0;
+    for (int i = 0; i < SVERDLE_LETTERS; i++) {
+        uint32_t g = (guess >> (5 * i)) & 31;
+        uint32_t a = (answer >> (5 * i)) & 31;
+        uint32_t hit = g == a;
+        exact |= hit << i;
+        left[a] += (uint8_t)(hit ^ 1);
+    }
+
+    /* Pass 2: a guess letter that is not exact is close while copies are
+     * left, and uses one up. */
+    uint32_t feedback = 0;
+    for (int i = 0; i < SVERDLE_LETTERS; i++) {
+        uint32_t g = (guess >> (5 * i)) & 31;
+        uint32_t hit = (exact >> i) & 1;
+        uint32_t close = (hit ^ 1) & (uint32_t)(left[g] != 0);
+        left[g] -= (uint8_t)close;
+        feedback += (hit * SVERDLE_EXACT + close * SVERDLE_CLOSE) * powers_of_3[i];
+    }
+    return (uint8_t)feedback;
+}
+
+SVERDLE_STATE sverdle_State(uint8_t feedback, int i) {
+    return (SVERDLE_STATE)(feedback / powers_of_3[i] % 3);
+}
+
+bool sverdle_Load(const void* data, size_t size) {
+    SverdleWords words;
+    if (!sverdle_View(data, size, &words)) {
+        return false;
+    }
+    table = words;
+    return true;
+}
+
+bool sverdle_Map(const char* path) {
+#ifdef HELLO_HAVE_MMAP
+    int fd;
+    do {
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    if (!sverdle_Load(data, (size_t)st.st_size)) {
+        munmap(data, (size_t)st.st_size);
+        return false;
+    }
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+size_t sverdle_WordsSize() {
+    return table.size;
+}
+
+} // namespace Hello
@@ -0,0 +1,117 @@
+#ifndef HELLO_SVERDLE_HPP
+#define HELLO_SVERDLE_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Hello
+{
+
+/*** SVERDLE **********************************************************/
+/*
+ * A five-letter word is packed into 25 bits, five per letter ('a' = 0 ..
+ * 'z' = 25) with the first letter in the lowest bits. The answer list and
+ * the allowed-guess dictionary are compiled from
+ * src/routes/sverdle/words.server.ts at build time (sverdle.words.mjs) into
+ * the word table below.
+ *
+ * Feedback for a guess is one byte: the sum over positions i of
+ * state_i * 3^i, where state is SVERDLE_MISS, SVERDLE_CLOSE or
+ * SVERDLE_EXACT, so 0 .. 242 covers every pattern.
+ */
+#define SVERDLE_LETTERS 5
+#define SVERDLE_INVALID 0xffffffffu
+#define SVERDLE_NO_INDEX ((size_t)-1)
+#define SVERDLE_FEEDBACK_COUNT 243
+#define SVERDLE_SOLVED 242
+
+enum SVERDLE_STATE { SVERDLE_MISS = 0, SVERDLE_CLOSE = 1, SVERDLE_EXACT = 2 };
+
+// Packs len bytes of lowercase letters; SVERDLE_INVALID unless len is 5
+// and every byte is 'a' .. 'z'.
+uint32_t sverdle_Pack(const char* letters, size_t len);
+void sverdle_Unpack(uint32_t word, char letters[SVERDLE_LETTERS]);
+
+size_t sverdle_AnswerCount();
+// Answer `index` of the words list, or SVERDLE_INVALID past the end.
+uint32_t sverdle_Answer(size_t index);
+
+// Whether word is in the allowed dictionary: two hashes, two table loads
+// and one compare (see the hash section below).
+bool sverdle_Allowed(uint32_t word);
+// Whether word is one of the answers.
+bool sverdle_IsAnswer(uint32_t word);
+
+// The allowed guesses in ascending packed order; SVERDLE_INVALID past the
+// end.
+size_t sverdle_GuessCount();
+uint32_t sverdle_Guess(size_t index);
+// Index of an allowed word, or SVERDLE_NO_INDEX.
+size_t sverdle_GuessIndex(uint32_t word);
+
+// Feedback for guess against answer, both packed. Exact matches are taken
+// first and consume their letter; each remaining guess letter is close if
+// an unconsumed copy is left in the answer. No branches on the letters.
+uint8_t sverdle_Score(uint32_t guess, uint32_t answer);
+
+// State of position i (0 .. 4) in a feedback byte.
+SVERDLE_STATE sverdle_State(uint8_t feedback, int i);
+
+/*** WORD TABLE *******************************************************/
+/*
+ * Both lists live in one read-only blob that is used in place: no parsing,
+ * no allocation. sverdle.words.mjs links it into the module's data segment
+ * and can also write it to a file that native tools map instead. It is
+ * little-endian, and every section starts on a 4-byte boundary at the
+ * offset the header gives:
+ *
+ *   words    uint32[word_count]       every allowed word, packed, ascending
+ *   seeds    uint16[bucket_count]     perfect hash of the words onto their
+ *   slots    uint16[slot_count]       indices, see below
+ *   answer   uint32[ceil(n / 32)]     bit i set when word i is an answer
+ *   answers  uint16[answer_count]     word index of each answer, in game
+ *                                     order
+ *
+ * The hash is built by hash and displace: a word is in bucket
+ * reduce(hash(word, 0), bucket_count), and its slot is
+ * reduce(hash(word, seeds[bucket]), slot_count), where each bucket's seed
+ * sends all its words to distinct slots. slots holds the word index there.
+ * Slots no word maps to hold 0, so a lookup needs no empty check: word is
+ * allowed exactly when words[slots[slot]] == word.
+ */
+#define SVERDLE_WORDS_MAGIC 0x4c575653u /* 'SVWL' */
+#define SVERDLE_WORDS_VERSION 2
+
+struct SverdleWordsHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size; // of the whole blob, in bytes
+    uint32_t word_count;
+    uint32_t answer_count;
+    uint32_t bucket_count;
+    uint32_t slot_count;
+    uint32_t words_offset;
+    uint32_t seeds_offset;
+    uint32_t slots_offset;
+    uint32_t answer_bits_offset;
+    uint32_t answers_offset;
+};
+
+// Switches every lookup to the table in data[0, size), which must stay
+// valid and unchanged from then on. Returns false, leaving the current
+// table in place, if it is not a well-formed table. Not safe while other
+// threads are looking words up, and solvers (sverdle_solver.hpp) built
+// before keep numbering guesses by the old table.
+bool sverdle_Load(const void* data, size_t size);
+
+// Maps a table file written by sverdle.words.mjs --bin read-only and loads
+// it. The mapping is never released. Returns false if the file cannot be
+// mapped or is not a table, and always where there is no mmap (wasm).
+bool sverdle_Map(const char* path);
+
+// Bytes of the table in use.
+size_t sverdle_WordsSize();
+
+} // namespace Hello
+
+#endif
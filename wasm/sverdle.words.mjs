@@ -0,0 +1,181 @@
+// Generates the Sverdle word table behind sverdle.cpp from the word lists
+// (the `words` array and the `allowed` set in
+// src/routes/sverdle/words.server.ts).
+//
+//   node sverdle.words.mjs ../src/routes/sverdle/words.server.ts [--bin=FILE] > sverdle_words.cpp
+//
+// The table is one read-only blob in the layout sverdle.hpp describes:
+// every allowed word packed into 25 bits (five per letter, first letter
+// lowest) and sorted, a perfect hash from word to index, a bitmap of which
+// words are answers and the answers' word indices in game order.
+// sverdle_words.cpp links it into the module's data segment; --bin also
+// writes the bare blob, for native tools to map with sverdle_Map.
+//
+// The hash is built by hash and displace: every word goes to bucket
+// hash(word, 0), and each bucket, largest first, is given the smallest seed
+// that sends all its words to free slots at hash(word, seed). A lookup is
+// then two hashes and one compare, with no probing.
+
+import fs from 'node:fs';
+
+// Keep in step with sverdle.hpp.
+const SVERDLE_WORDS_MAGIC = 0x4c575653; // 'SVWL'
+const SVERDLE_WORDS_VERSION = 2;
+const HEADER_WORDS = 12;
+
+const KEYS_PER_BUCKET = 4;
+// Slot counts to try, as a load factor: minimal (one slot per word) first;
+// a lower load is only needed if some bucket finds no 16-bit seed.
+const LOADS = [1, 0.95, 0.9];
+
+let input = '../src/routes/sverdle/words.server.ts';
+let binPath = null;
+for(const arg of process.argv.slice(2)) {
+    if(arg.startsWith('--bin=')) {
+        binPath = arg.slice(6);
+    } else {
+        input = arg;
+    }
+}
+
+const source = fs.readFileSync(input, 'utf8');
+const list = (name) => {
+    const body = source.match(new RegExp(`export const ${name}[^\\[]*\\[([^\\]]*)\\]`))?.[1];
+    if(!body) {
+        console.error(`sverdle.words.mjs: no '${name}' list in ${input}`);
+        process.exit(1);
+    }
+    return [...body.matchAll(/'([a-z]{5})'/g)].map((m) => m[1]);
+};
+const words = list('words');
+// allowed is `new Set([...words, ...])`
+const allowed = [...new Set([...words, ...list('allowed')])];
+
+function pack(word) {
+    let packed = 0;
+    for(let i = 4; i >= 0; i--) {
+        packed = (packed << 5) | (word.charCodeAt(i) - 97);
+    }
+    return packed;
+}
+
+const sorted = Uint32Array.from(allowed.map(pack)).sort();
+if(sorted.length > 0xffff) {
+    console.error('sverdle.words.mjs: more than 65535 words do not fit 16-bit word indices');
+    process.exit(1);
+}
+const position = new Map(Array.from(sorted, (code, i) => [code, i]));
+
+// Keep in step with sverdle_hash and reduce in sverdle.cpp.
+function hash(key, seed) {
+    let x = (key ^ seed) >>> 0;
+    x = Math.imul(x ^ (x >>> 16), 0x7feb352d);
+    x = Math.imul(x ^ (x >>> 15), 0x846ca68b);
+    return (x ^ (x >>> 16)) >>> 0;
+}
+const reduce = (h, n) => Math.floor((h * n) / 0x100000000);
+
+const bucketCount = Math.ceil(sorted.length / KEYS_PER_BUCKET);
+const buckets = Array.from({ length: bucketCount }, () => []);
+for(const key of sorted) {
+    buckets[reduce(hash(key, 0), bucketCount)].push(key);
+}
+const order = buckets.map((_, b) => b).sort((a, b) => buckets[b].length - buckets[a].length);
+
+// Returns { slots, seeds }, or null if some bucket needs a seed above 16
+// bits. Slots no word maps to are left at 0 (see sverdle.hpp).
+function place(slotCount) {
+    const used = new Uint8Array(slotCount);
+    const slots = new Uint16Array(slotCount);
+    const seeds = new Uint16Array(bucketCount);
+    for(const b of order) {
+        const bucket = buckets[b];
+        if(!bucket.length) {
+            continue;
+        }
+        for(let seed = 1; ; seed++) {
+            if(seed > 0xffff) {
+                return null;
+            }
+            const at = bucket.map((key) => reduce(hash(key, seed), slotCount));
+            if(at.every((slot, i) => !used[slot] && at.indexOf(slot) === i)) {
+                at.forEach((slot, i) => {
+                    used[slot] = 1;
+                    slots[slot] = position.get(bucket[i]);
+                });
+                seeds[b] = seed;
+                break;
+            }
+        }
+    }
+    return { slots, seeds };
+}
+
+let placed = null;
+for(const load of LOADS) {
+    if((placed = place(Math.ceil(sorted.length / load)))) {
+        break;
+    }
+}
+if(!placed) {
+    console.error('sverdle.words.mjs: no perfect hash found');
+    process.exit(1);
+}
+const { slots, seeds } = placed;
+
+const answerBits = new Uint32Array(Math.ceil(sorted.length / 32));
+const answers = new Uint16Array(words.length);
+words.forEach((word, i) => {
+    const at = position.get(pack(word));
+    answers[i] = at;
+    answerBits[at >>> 5] |= 1 << (at & 31);
+});
+
+// Sections in order, each starting on a 4-byte boundary.
+const align4 = (n) => (n + 3) & ~3;
+const wordsOffset = HEADER_WORDS * 4;
+const seedsOffset = wordsOffset + sorted.byteLength;
+const slotsOffset = seedsOffset + align4(seeds.byteLength);
+const bitsOffset = slotsOffset + align4(slots.byteLength);
+const answersOffset = bitsOffset + answerBits.byteLength;
+const size = answersOffset + align4(answers.byteLength);
+
+const blob = new ArrayBuffer(size);
+const view = new DataView(blob);
+[SVERDLE_WORDS_MAGIC, SVERDLE_WORDS_VERSION, size, sorted.length, words.length, bucketCount, slots.length,
+    wordsOffset, seedsOffset, slotsOffset, bitsOffset, answersOffset]
+    .forEach((value, i) => view.setUint32(i * 4, value, true));
+const put = (offset, array, width) => array.forEach((value, i) => (width === 4 ? view.setUint32(offset + i * 4, value, true) : view.setUint16(offset + i * 2, value, true)));
+put(wordsOffset, sorted, 4);
+put(seedsOffset, seeds, 2);
+put(slotsOffset, slots, 2);
+put(bitsOffset, answerBits, 4);
+put(answersOffset, answers, 2);
+
+if(binPath) {
+    fs.writeFileSync(binPath, new Uint8Array(blob));
+}
+
+const blobWords = new Uint32Array(size / 4).map((_, i) => view.getUint32(i * 4, true));
+const rows = [];
+for(let i = 0; i < blobWords.length; i += 8) {
+    rows.push('    ' + Array.from(blobWords.subarray(i, i + 8), (v) => '0x' + v.toString(16).padStart(8, '0')).join(', ') + ',');
+}
+
+process.stdout.write(`// Generated from ${input} by sverdle.words.mjs; do not edit.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Hello
+{
+
+// ${sorted.length} allowed words, ${words.length} of them answers; ${bucketCount} hash buckets
+// and ${slots.length} slots. ${size} bytes, as 32-bit little-endian words.
+extern const size_t sverdle_words_size = ${size};
+alignas(8) extern const uint32_t sverdle_words_blob[] = {
+${rows.join('\n')}
+};
+
+} // namespace Hello
+`);
@@ -0,0 +1,266 @@
+#include "sverdle_solver.hpp"
+
+#include <math.h>
+#include <string.h>
+
+#include "thread_pool.hpp"
+
+#if defined(__SSE2__)
+#define HELLO_SVERDLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace Hello
+{
+
+/*** FEEDBACK MATRIX ****/
+
+SverdleMatrix::SverdleMatrix()
+    : guesses_(sverdle_GuessCount()), answers_(sverdle_AnswerCount()), stride_((sverdle_AnswerCount() + 63) / 64 * 64),
+      answer_of_(guesses_, SVERDLE_NO_INDEX) {
+    size_t blocks = (guesses_ + SVERDLE_MATRIX_BLOCK - 1) / SVERDLE_MATRIX_BLOCK;
+    blocks_.reset(new std::unique_ptr<uint8_t[]>[blocks]);
+    built_.reset(new std::once_flag[blocks]);
+    for (size_t a = 0; a < answers_; a++) {
+        size_t guess = sverdle_GuessIndex(sverdle_Answer(a));
+        if (guess != SVERDLE_NO_INDEX) {
+            answer_of_[guess] = a;
+        }
+    }
+}
+
+/* One block at a time, answer-major inside it: the 64 guesses of a block
+ * stay in registers/L1 while the answers stream past once. */
+void SverdleMatrix::build(size_t block) {
+    size_t first = block * SVERDLE_MATRIX_BLOCK;
+    size_t rows = guesses_ - first < SVERDLE_MATRIX_BLOCK ? guesses_ - first : SVERDLE_MATRIX_BLOCK;
+    uint8_t* data = new uint8_t[rows * stride_];
+    memset(data, 0xff, rows * stride_);
+    uint32_t guess[SVERDLE_MATRIX_BLOCK];
+    for (size_t r = 0; r < rows; r++) {
+        guess[r] = sverdle_Guess(first + r);
+    }
+    for (size_t a = 0; a < answers_; a++) {
+        uint32_t answer = sverdle_Answer(a);
+        for (size_t r = 0; r < rows; r++) {
+            data[r * stride_ + a] = sverdle_Score(guess[r], answer);
+        }
+    }
+    blocks_[block].reset(data);
+}
+
+const uint8_t* SverdleMatrix::row(size_t guess) {
+    size_t block = guess / SVERDLE_MATRIX_BLOCK;
+    std::call_once(built_[block], [this, block] { build(block); });
+    return blocks_[block].get() + (guess % SVERDLE_MATRIX_BLOCK) * stride_;
+}
+
+size_t SverdleMatrix::bytes() const {
+    /* Only meaningful while no block is being built. */
+    size_t total = 0;
+    size_t blocks = (guesses_ + SVERDLE_MATRIX_BLOCK - 1) / SVERDLE_MATRIX_BLOCK;
+    for (size_t b = 0; b < blocks; b++) {
+        if (blocks_[b]) {
+            size_t first = b * SVERDLE_MATRIX_BLOCK;
+            size_t rows = guesses_ - first < SVERDLE_MATRIX_BLOCK ? guesses_ - first : SVERDLE_MATRIX_BLOCK;
+            total += rows * stride_;
+        }
+    }
+    return total;
+}
+
+SverdleMatrix& SverdleMatrix::shared() {
+    static SverdleMatrix matrix;
+    return matrix;
+}
+
+/*** CANDIDATE SETS ****/
+
+/* Bit i set where p[i] == feedback, for 64 bytes. */
+static inline uint64_t match64(const uint8_t* p, uint8_t feedback) {
+#if defined(HELLO_SVERDLE_SSE2)
+    const __m128i f = _mm_set1_epi8((char)feedback);
+    uint64_t m0 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), f));
+    uint64_t m1 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + 16)), f));
+    uint64_t m2 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + 32)), f));
+    uint64_t m3 = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(p + 48)), f));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+#elif defined(__wasm_simd128__)
+    const v128_t f = wasm_i8x16_splat((int8_t)feedback);
+    uint64_t m0 = wasm_i8x16_bitmask(wasm_i8x16_eq(wasm_v128_load(p), f));
+    uint64_t m1 = wasm_i8x16_bitmask(wasm_i8x16_eq(wasm_v128_load(p + 16), f));
+    uint64_t m2 = wasm_i8x16_bitmask(wasm_i8x16_eq(wasm_v128_load(p + 32), f));
+    uint64_t m3 = wasm_i8x16_bitmask(wasm_i8x16_eq(wasm_v128_load(p + 48), f));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) {
+        mask |= (uint64_t)(p[i] == feedback) << i;
+    }
+    return mask;
+#endif
+}
+
+size_t sverdle_Filter(const uint8_t* row, uint8_t feedback, uint64_t* set, size_t words) {
+    size_t left = 0;
+    for (size_t w = 0; w < words; w++) {
+        if (set[w]) {
+            set[w] &= match64(row + w * 64, feedback);
+            left += (size_t)__builtin_popcountll(set[w]);
+        }
+    }
+    return left;
+}
+
+/*** SOLVER ****/
+
+SverdleSolver::SverdleSolver(SverdleMatrix& matrix, ThreadPool* pool)
+    : matrix_(matrix), pool_(pool ? pool : &ThreadPool::shared()), candidates_(matrix.words()), remaining_(0),
+      plogp_(matrix.answers() + 1), have_opening_(false), opening_(), opened_(-1), applied_(0), have_second_(),
+      second_() {
+    for (size_t c = 1; c < plogp_.size(); c++) {
+        plogp_[c] = (double)c * log2((double)c);
+    }
+    reset();
+}
+
+void SverdleSolver::reset() {
+    size_t answers = matrix_.answers();
+    for (size_t w = 0; w < candidates_.size(); w++) {
+        size_t bits = answers - w * 64 < 64 ? answers - w * 64 : 64;
+        candidates_[w] = bits == 64 ? ~0ull : (1ull << bits) - 1;
+    }
+    remaining_ = answers;
+    opened_ = -1;
+    applied_ = 0;
+}
+
+bool SverdleSolver::apply(uint32_t guess, uint8_t feedback) {
+    size_t index = sverdle_GuessIndex(guess);
+    if (index == SVERDLE_NO_INDEX) {
+        return false;
+    }
+    remaining_ = sverdle_Filter(matrix_.row(index), feedback, candidates_.data(), candidates_.size());
+    opened_ = applied_ == 0 && have_opening_ && index == opening_.guess ? feedback : -1;
+    applied_++;
+    return true;
+}
+
+bool SverdleSolver::better(const Pick& a, const Pick& b) {
+    if (a.entropy != b.entropy) {
+        return a.entropy > b.entropy;
+    }
+    if (a.candidate != b.candidate) {
+        return a.candidate;
+    }
+    return a.guess < b.guess;
+}
+
+/* Entropy of the feedback distribution of guess over the candidates
+ * (their answer indices): log2(n) - sum(c log2 c) / n over the bucket
+ * counts c. Only the buckets hit are summed and cleared again, which after
+ * the first guess is a handful rather than 243. */
+SverdleSolver::Pick SverdleSolver::score(size_t guess, const uint16_t* candidates, size_t n) {
+    const uint8_t* row = matrix_.row(guess);
+    uint16_t counts[SVERDLE_FEEDBACK_COUNT] = {0};
+    uint8_t hit[SVERDLE_FEEDBACK_COUNT];
+    size_t hits = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint8_t f = row[candidates[i]];
+        hit[hits] = f;
+        hits += counts[f]++ == 0;
+    }
+    double sum = 0;
+    for (size_t i = 0; i < hits; i++) {
+        sum += plogp_[counts[hit[i]]];
+    }
+    size_t answer = matrix_.answer_of(guess);
+    bool candidate = answer != SVERDLE_NO_INDEX && ((candidates_[answer / 64] >> (answer % 64)) & 1);
+    return {log2((double)n) - sum / (double)n, candidate, guess};
+}
+
+/* Scores every guess, a matrix block per task. */
+SverdleSolver::Pick SverdleSolver::search() {
+    size_t guesses = matrix_.guesses();
+    size_t blocks = (guesses + SVERDLE_MATRIX_BLOCK - 1) / SVERDLE_MATRIX_BLOCK;
+    std::vector<uint16_t> candidates;
+    candidates.reserve(remaining_);
+    for (size_t w = 0; w < candidates_.size(); w++) {
+        for (uint64_t bits = candidates_[w]; bits; bits &= bits - 1) {
+            candidates.push_back((uint16_t)(w * 64 + (size_t)__builtin_ctzll(bits)));
+        }
+    }
+    std::vector<Pick> picks(blocks, Pick{-1, false, SVERDLE_NO_INDEX});
+    pool_->parallel_for(blocks, [&](size_t block) {
+        size_t end = (block + 1) * SVERDLE_MATRIX_BLOCK < guesses ? (block + 1) * SVERDLE_MATRIX_BLOCK : guesses;
+        for (size_t g = block * SVERDLE_MATRIX_BLOCK; g < end; g++) {
+            Pick pick = score(g, candidates.data(), candidates.size());
+            if (better(pick, picks[block])) {
+                picks[block] = pick;
+            }
+        }
+    });
+    Pick pick = picks[0];
+    for (size_t b = 1; b < blocks; b++) {
+        if (better(picks[b], pick)) {
+            pick = picks[b];
+        }
+    }
+    return pick;
+}
+
+uint32_t SverdleSolver::best(double* entropy) {
+    if (remaining_ == 0) {
+        return SVERDLE_INVALID;
+    }
+    Pick pick;
+    if (remaining_ == 1) {
+        size_t w = 0;
+        while (!candidates_[w]) {
+            w++;
+        }
+        size_t answer = w * 64 + (size_t)__builtin_ctzll(candidates_[w]);
+        pick = {0, true, sverdle_GuessIndex(sverdle_Answer(answer))};
+    } else if (applied_ == 0) {
+        if (!have_opening_) {
+            opening_ = search();
+            have_opening_ = true;
+        }
+        pick = opening_;
+    } else if (applied_ == 1 && opened_ >= 0) {
+        if (!have_second_[opened_]) {
+            second_[opened_] = search();
+            have_second_[opened_] = true;
+        }
+        pick = second_[opened_];
+    } else {
+        pick = search();
+    }
+    if (entropy) {
+        *entropy = pick.entropy;
+    }
+    return sverdle_Guess(pick.guess);
+}
+
+int SverdleSolver::solve(size_t answer) {
+    uint32_t word = sverdle_Answer(answer);
+    if (word == SVERDLE_INVALID) {
+        return 0;
+    }
+    reset();
+    for (int turn = 1; turn <= SVERDLE_MAX_TURNS; turn++) {
+        uint32_t guess = best();
+        uint8_t feedback = sverdle_Score(guess, word);
+        if (feedback == SVERDLE_SOLVED) {
+            return turn;
+        }
+        apply(guess, feedback);
+    }
+    return 0;
+}
+
+} // namespace Hello
@@ -0,0 +1,148 @@
+#ifndef HELLO_SVERDLE_SOLVER_HPP
+#define HELLO_SVERDLE_SOLVER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "sverdle.hpp"
+
+namespace Hello
+{
+
+class ThreadPool;
+
+/*** FEEDBACK MATRIX **************************************************/
+/*
+ * feedback[guess][answer] = sverdle_Score(guess, answer) for every allowed
+ * guess (numbered as in sverdle_Guess) against every answer, one byte each.
+ * Rows are padded with 0xff, which is no feedback, to a multiple of 64
+ * answers so a row compares against a feedback byte in whole 64-bit words
+ * of a candidate set.
+ *
+ * The full matrix is about 30 MB, so it is built lazily in blocks of
+ * SVERDLE_MATRIX_BLOCK consecutive rows: filtering a game only touches the
+ * rows of the guesses played, and a block is built at most once even when
+ * several threads ask for it.
+ */
+#define SVERDLE_MATRIX_BLOCK 64
+
+class SverdleMatrix {
+public:
+    SverdleMatrix();
+
+    SverdleMatrix(const SverdleMatrix&) = delete;
+    SverdleMatrix& operator=(const SverdleMatrix&) = delete;
+
+    size_t guesses() const { return guesses_; }
+    size_t answers() const { return answers_; }
+    // Bytes per row, and 64-bit words per candidate set.
+    size_t stride() const { return stride_; }
+    size_t words() const { return stride_ / 64; }
+
+    // Row of guess (< guesses()), building its block first if needed.
+    const uint8_t* row(size_t guess);
+
+    // Answer index of guess, or SVERDLE_NO_INDEX if it is not an answer.
+    size_t answer_of(size_t guess) const { return answer_of_[guess]; }
+
+    // Bytes of the blocks built so far.
+    size_t bytes() const;
+
+    static SverdleMatrix& shared();
+
+private:
+    void build(size_t block);
+
+    size_t guesses_;
+    size_t answers_;
+    size_t stride_;
+    std::vector<size_t> answer_of_;
+    std::unique_ptr<std::unique_ptr<uint8_t[]>[]> blocks_;
+    std::unique_ptr<std::once_flag[]> built_;
+};
+
+/*** CANDIDATE SETS ***************************************************/
+/*
+ * A candidate set is a bitset over answer indices, matrix.words() 64-bit
+ * words long. Filtering with a played guess keeps the answers whose row
+ * byte equals the feedback: 64 bytes at a time are compared and their
+ * equality mask is ANDed into one word (SSE2 or wasm SIMD when available).
+ */
+
+// set &= (row == feedback), over words 64-bit words. Returns the bits left.
+size_t sverdle_Filter(const uint8_t* row, uint8_t feedback, uint64_t* set, size_t words);
+
+/*** SOLVER ***********************************************************/
+/*
+ * Picks the guess that maximizes the expected information of its feedback
+ * over the remaining candidates: the entropy of the distribution of
+ * feedback bytes in the guess's row, counted over the candidate bits. Every
+ * allowed guess is scored, spread across the pool in matrix blocks. Ties go
+ * to a guess that is itself a candidate (it might win outright), then to
+ * the lowest index, so a game is deterministic whatever the thread count.
+ *
+ * The opening guess depends on nothing but the word lists, and the second
+ * guess after it on nothing but the opening's feedback, so both are
+ * computed once per solver and reused by every later game.
+ */
+#define SVERDLE_MAX_TURNS 16
+
+class SverdleSolver {
+public:
+    // pool == nullptr uses the shared pool.
+    explicit SverdleSolver(SverdleMatrix& matrix = SverdleMatrix::shared(), ThreadPool* pool = nullptr);
+
+    // Back to every answer.
+    void reset();
+
+    // Narrows the candidates by a played guess (packed) and its feedback.
+    // Returns false, leaving them unchanged, if guess is not allowed.
+    bool apply(uint32_t guess, uint8_t feedback);
+
+    // Number of candidates left, and the set itself.
+    size_t remaining() const { return remaining_; }
+    const uint64_t* candidates() const { return candidates_.data(); }
+
+    // Best next guess (packed); SVERDLE_INVALID if no candidate is left.
+    // entropy, if given, receives the expected information in bits.
+    uint32_t best(double* entropy = nullptr);
+
+    // Plays answer (an answer index) from scratch and returns the number of
+    // guesses to solve it, or 0 if it is not solved in SVERDLE_MAX_TURNS.
+    int solve(size_t answer);
+
+    SverdleMatrix& matrix() const { return matrix_; }
+
+private:
+    struct Pick {
+        double entropy;
+        bool candidate;
+        size_t guess;
+    };
+
+    static bool better(const Pick& a, const Pick& b);
+    Pick score(size_t guess, const uint16_t* candidates, size_t n);
+    Pick search();
+
+    SverdleMatrix& matrix_;
+    ThreadPool* pool_;
+    std::vector<uint64_t> candidates_;
+    size_t remaining_;
+    // c * log2(c) for c in [0, answers]; answers fit 16 bits
+    std::vector<double> plogp_;
+    bool have_opening_;
+    Pick opening_;
+    // Feedback to the opening when it was the only guess applied, else -1.
+    int opened_;
+    size_t applied_;
+    bool have_second_[SVERDLE_FEEDBACK_COUNT];
+    Pick second_[SVERDLE_FEEDBACK_COUNT];
+};
+
+} // namespace Hello
+
+#endif
@@ -0,0 +1,152 @@
+#include "thread_pool.hpp"
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define HELLO_NO_THREADS 1
+#endif
+
+namespace Hello
+{
+
+// Worker index of the current thread within the pool it belongs to.
+static thread_local const ThreadPool* current_pool = nullptr;
+static thread_local size_t current_index = 0;
+
+ThreadPool::ThreadPool(size_t threads) : pending_(0), next_queue_(0), stopping_(false) {
+#ifdef HELLO_NO_THREADS
+    threads = 0;
+#else
+    if(threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+#endif
+    // One queue per worker, plus one for submissions from outside the pool.
+    for(size_t i = 0; i <= threads; i++) {
+        queues_.emplace_back(new Queue());
+    }
+    for(size_t i = 0; i < threads; i++) {
+        workers_.emplace_back(&ThreadPool::worker, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for(auto& t: workers_) {
+        t.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    if(workers_.empty()) {
+        task();
+        return;
+    }
+    size_t target = (current_pool == this) ? current_index : next_queue_++ % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    pending_++;
+    {
+        // Taking the lock orders this wake-up after a sleeper's check of
+        // pending_, so it cannot be lost.
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::pop(size_t self, std::function<void()>& task) {
+    // Own queue first, newest task (LIFO keeps caches warm)...
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if(!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending_--;
+            return true;
+        }
+    }
+    // ...then steal the oldest task from someone else.
+    for(size_t k = 1; k < queues_.size(); k++) {
+        Queue& victim = *queues_[(self + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending_--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker(size_t index) {
+    current_pool = this;
+    current_index = index;
+    std::function<void()> task;
+    for(;;) {
+        if(pop(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_.wait(lock, [this] { return stopping_ || pending_ > 0; });
+        if(stopping_ && pending_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::parallel_for(size_t n, const std::function<void(size_t)>& fn) {
+    if(workers_.empty() || n == 1) {
+        for(size_t i = 0; i < n; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    struct Join {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+    } join;
+    join.remaining = n;
+
+    for(size_t i = 0; i < n; i++) {
+        submit([&join, &fn, i] {
+            fn(i);
+            std::lock_guard<std::mutex> lock(join.mutex);
+            if(--join.remaining == 0) {
+                join.done.notify_all();
+            }
+        });
+    }
+
+    // Help out instead of blocking while there is anything left to run.
+    size_t self = (current_pool == this) ? current_index : queues_.size() - 1;
+    std::function<void()> task;
+    while(join.remaining > 0) {
+        if(pop(self, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(join.mutex);
+        join.done.wait(lock, [&join] { return join.remaining == 0; });
+    }
+    // The last task decrements under the lock; acquiring it here guarantees
+    // that task is done with join before it goes out of scope.
+    std::lock_guard<std::mutex> lock(join.mutex);
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace Hello
@@ -0,0 +1,65 @@
+#ifndef HELLO_THREAD_POOL_HPP
+#define HELLO_THREAD_POOL_HPP
+
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hello
+{
+
+// Work-stealing thread pool. Every worker owns a deque: it pops its own
+// newest task first and, when that runs dry, steals the oldest task of
+// another worker. On a wasm build without pthreads there are no workers and
+// everything runs inline on the calling thread.
+class ThreadPool {
+public:
+    // threads == 0 sizes the pool to std::thread::hardware_concurrency().
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of worker threads; 0 means tasks run inline.
+    size_t size() const { return workers_.size(); }
+
+    // Queues a task. From inside a worker it lands on that worker's own
+    // deque, so recursive work stays local until someone steals it.
+    void submit(std::function<void()> task);
+
+    // Runs fn(i) for every i in [0, n) and returns once all calls have
+    // finished. The calling thread runs tasks too, so nesting is safe.
+    void parallel_for(size_t n, const std::function<void(size_t)>& fn);
+
+    // Process-wide pool sized to the machine.
+    static ThreadPool& shared();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool pop(size_t self, std::function<void()>& task);
+    void worker(size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> pending_;
+    std::atomic<size_t> next_queue_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+};
+
+} // namespace Hello
+
+#endif
@@ -0,0 +1,865 @@
+#include "typed_array.hpp"
+
+#include <math.h>
+#include <string.h>
+
+#include <atomic>
+#include <limits>
+#include <type_traits>
+
+#include "cpu.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HELLO_ARRAY_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace Hello
+{
+
+/* The unsigned integer with the size of T: what min/max, sums and integer
+ * prefix sums run on. */
+template <size_t S> struct ArrayBits;
+template <> struct ArrayBits<1> { typedef uint8_t type; };
+template <> struct ArrayBits<2> { typedef uint16_t type; };
+template <> struct ArrayBits<4> { typedef uint32_t type; };
+template <> struct ArrayBits<8> { typedef uint64_t type; };
+
+template <typename T> using BitsOf = typename ArrayBits<sizeof(T)>::type;
+
+/* The sign bit for a signed integer T, else 0. x ^ bias orders signed values
+ * the way unsigned compares order the result. */
+template <typename T> static constexpr BitsOf<T> sign_bias() {
+    return std::is_integral<T>::value && std::is_signed<T>::value ? (BitsOf<T>)((BitsOf<T>)1 << (8 * sizeof(T) - 1))
+                                                                   : (BitsOf<T>)0;
+}
+
+static inline uint8_t bswap(uint8_t x) { return x; }
+static inline uint16_t bswap(uint16_t x) { return __builtin_bswap16(x); }
+static inline uint32_t bswap(uint32_t x) { return __builtin_bswap32(x); }
+static inline uint64_t bswap(uint64_t x) { return __builtin_bswap64(x); }
+
+/*** SCALAR ***********************************************************/
+/*
+ * The plain loops. The vector kernels finish their tails with them, each
+ * carrying its running state (the min/max so far, a prefix sum's last
+ * value) in and out.
+ */
+template <typename T> static void reverse_scalar(T* p, size_t n) {
+    for (size_t i = 0, j = n; i + 1 < j; i++, j--) {
+        T t = p[i];
+        p[i] = p[j - 1];
+        p[j - 1] = t;
+    }
+}
+
+template <typename T> static void byteswap_scalar(T* p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        BitsOf<T> bits;
+        memcpy(&bits, &p[i], sizeof(bits));
+        bits = bswap(bits);
+        memcpy(&p[i], &bits, sizeof(bits));
+    }
+}
+
+/* lo and hi hold biased values and are updated in place. */
+template <typename U> static void minmax_scalar(const U* p, size_t n, U bias, U* lo, U* hi) {
+    for (size_t i = 0; i < n; i++) {
+        U x = (U)(p[i] ^ bias);
+        *lo = x < *lo ? x : *lo;
+        *hi = x > *hi ? x : *hi;
+    }
+}
+
+template <typename T> static void minmax_float_scalar(const T* p, size_t n, T* lo, T* hi, bool* nan) {
+    for (size_t i = 0; i < n; i++) {
+        T x = p[i];
+        *nan |= x != x;
+        *lo = x < *lo ? x : *lo;
+        *hi = x > *hi ? x : *hi;
+    }
+}
+
+/* Sum of the biased values. */
+template <typename U> static uint64_t sum_scalar(const U* p, size_t n, U bias) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += (U)(p[i] ^ bias);
+    }
+    return sum;
+}
+
+template <typename T> static double sum_float_scalar(const T* p, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += p[i];
+    }
+    return sum;
+}
+
+/* Adds carry (the previous element's prefix sum) into the first element. */
+template <typename T> static void prefix_scalar(T* p, size_t n, T carry) {
+    for (size_t i = 0; i < n; i++) {
+        carry = (T)(carry + p[i]);
+        p[i] = carry;
+    }
+}
+
+/*** AVX2 *************************************************************/
+/*
+ * Reverse swaps 32-byte blocks from both ends, reversing the elements of
+ * each with a byte shuffle within 128-bit lanes and a lane swap (or one
+ * cross-lane permute for 4- and 8-byte elements), and leaves the middle
+ * to the scalar loop. Min/max keep one vector of each; 64-bit integers,
+ * which have no vector min, compare with the sign bit flipped. Integer sums
+ * widen into 64-bit lanes (PSADBW does it for bytes), and prefix sums scan
+ * 128 bits at a time with shift-and-add, since 256-bit byte shifts do not
+ * cross lanes.
+ */
+#ifdef HELLO_ARRAY_X86
+#define HELLO_AVX2 __attribute__((target("avx2")))
+
+template <size_t S> HELLO_AVX2 static inline __m256i reverse_lanes_avx2(__m256i v) {
+    if constexpr (S == 8) {
+        return _mm256_permute4x64_epi64(v, 0x1B);
+    } else if constexpr (S == 4) {
+        return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    } else {
+        const __m256i mask = S == 2 ? _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                                       14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1)
+                                    : _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                                       15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, mask), 0x4E);
+    }
+}
+
+template <typename T> HELLO_AVX2 static void reverse_avx2(T* p, size_t n) {
+    const size_t k = 32 / sizeof(T);
+    size_t i = 0;
+    size_t j = n;
+    for (; j - i >= 2 * k; i += k, j -= k) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(p + j - k));
+        _mm256_storeu_si256((__m256i*)(p + i), reverse_lanes_avx2<sizeof(T)>(b));
+        _mm256_storeu_si256((__m256i*)(p + j - k), reverse_lanes_avx2<sizeof(T)>(a));
+    }
+    reverse_scalar(p + i, j - i);
+}
+
+template <typename T> HELLO_AVX2 static void byteswap_avx2(T* p, size_t n) {
+    if constexpr (sizeof(T) > 1) {
+        const __m256i mask =
+            sizeof(T) == 2 ? _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                              1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+            : sizeof(T) == 4 ? _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+                             : _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                                7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        const size_t k = 32 / sizeof(T);
+        size_t i = 0;
+        for (; i + k <= n; i += k) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+            _mm256_storeu_si256((__m256i*)(p + i), _mm256_shuffle_epi8(v, mask));
+        }
+        byteswap_scalar(p + i, n - i);
+    }
+}
+
+template <typename U> HELLO_AVX2 static inline __m256i splat_avx2(U x) {
+    if constexpr (sizeof(U) == 1) {
+        return _mm256_set1_epi8((char)x);
+    } else if constexpr (sizeof(U) == 2) {
+        return _mm256_set1_epi16((short)x);
+    } else if constexpr (sizeof(U) == 4) {
+        return _mm256_set1_epi32((int)x);
+    } else {
+        return _mm256_set1_epi64x((long long)x);
+    }
+}
+
+template <typename U> HELLO_AVX2 static inline void minmax_lanes_avx2(__m256i* lo, __m256i* hi, __m256i v) {
+    if constexpr (sizeof(U) == 1) {
+        *lo = _mm256_min_epu8(*lo, v);
+        *hi = _mm256_max_epu8(*hi, v);
+    } else if constexpr (sizeof(U) == 2) {
+        *lo = _mm256_min_epu16(*lo, v);
+        *hi = _mm256_max_epu16(*hi, v);
+    } else if constexpr (sizeof(U) == 4) {
+        *lo = _mm256_min_epu32(*lo, v);
+        *hi = _mm256_max_epu32(*hi, v);
+    } else {
+        const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+        __m256i s = _mm256_xor_si256(v, sign);
+        __m256i below = _mm256_cmpgt_epi64(_mm256_xor_si256(*lo, sign), s);
+        __m256i above = _mm256_cmpgt_epi64(s, _mm256_xor_si256(*hi, sign));
+        *lo = _mm256_blendv_epi8(*lo, v, below);
+        *hi = _mm256_blendv_epi8(*hi, v, above);
+    }
+}
+
+template <typename U> HELLO_AVX2 static void minmax_avx2(const U* p, size_t n, U bias, U* lo, U* hi) {
+    const size_t k = 32 / sizeof(U);
+    size_t i = 0;
+    if (n >= k) {
+        const __m256i b = splat_avx2<U>(bias);
+        __m256i vlo = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)p), b);
+        __m256i vhi = vlo;
+        for (i = k; i + k <= n; i += k) {
+            minmax_lanes_avx2<U>(&vlo, &vhi, _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + i)), b));
+        }
+        U lanes[2][32 / sizeof(U)];
+        _mm256_storeu_si256((__m256i*)lanes[0], vlo);
+        _mm256_storeu_si256((__m256i*)lanes[1], vhi);
+        /* The lanes are biased already. */
+        minmax_scalar(lanes[0], k, (U)0, lo, hi);
+        minmax_scalar(lanes[1], k, (U)0, lo, hi);
+    }
+    minmax_scalar(p + i, n - i, bias, lo, hi);
+}
+
+/* MINPS/MAXPS return the second operand when either is NaN, so NaNs do
+ * not stick in the lanes and are tracked separately. */
+HELLO_AVX2 static void minmax_f32_avx2(const float* p, size_t n, float* lo, float* hi, bool* nan) {
+    size_t i = 0;
+    if (n >= 8) {
+        __m256 vlo = _mm256_loadu_ps(p);
+        __m256 vhi = vlo;
+        __m256 vnan = _mm256_cmp_ps(vlo, vlo, _CMP_UNORD_Q);
+        for (i = 8; i + 8 <= n; i += 8) {
+            __m256 v = _mm256_loadu_ps(p + i);
+            vlo = _mm256_min_ps(vlo, v);
+            vhi = _mm256_max_ps(vhi, v);
+            vnan = _mm256_or_ps(vnan, _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+        }
+        float lanes[2][8];
+        _mm256_storeu_ps(lanes[0], vlo);
+        _mm256_storeu_ps(lanes[1], vhi);
+        *nan |= _mm256_movemask_ps(vnan) != 0;
+        minmax_float_scalar(lanes[0], 8, lo, hi, nan);
+        minmax_float_scalar(lanes[1], 8, lo, hi, nan);
+    }
+    minmax_float_scalar(p + i, n - i, lo, hi, nan);
+}
+
+HELLO_AVX2 static void minmax_f64_avx2(const double* p, size_t n, double* lo, double* hi, bool* nan) {
+    size_t i = 0;
+    if (n >= 4) {
+        __m256d vlo = _mm256_loadu_pd(p);
+        __m256d vhi = vlo;
+        __m256d vnan = _mm256_cmp_pd(vlo, vlo, _CMP_UNORD_Q);
+        for (i = 4; i + 4 <= n; i += 4) {
+            __m256d v = _mm256_loadu_pd(p + i);
+            vlo = _mm256_min_pd(vlo, v);
+            vhi = _mm256_max_pd(vhi, v);
+            vnan = _mm256_or_pd(vnan, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        }
+        double lanes[2][4];
+        _mm256_storeu_pd(lanes[0], vlo);
+        _mm256_storeu_pd(lanes[1], vhi);
+        *nan |= _mm256_movemask_pd(vnan) != 0;
+        minmax_float_scalar(lanes[0], 4, lo, hi, nan);
+        minmax_float_scalar(lanes[1], 4, lo, hi, nan);
+    }
+    minmax_float_scalar(p + i, n - i, lo, hi, nan);
+}
+
+HELLO_AVX2 static inline uint64_t sum_lanes_avx2(__m256i v) {
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+template <typename U> HELLO_AVX2 static uint64_t sum_avx2(const U* p, size_t n, U bias) {
+    const size_t k = 32 / sizeof(U);
+    const __m256i b = splat_avx2<U>(bias);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc = zero;
+    size_t i = 0;
+    if constexpr (sizeof(U) == 2) {
+        /* 32-bit lanes take two 16-bit values a step: flush them into the
+         * 64-bit sums before 2^15 steps can overflow them. */
+        while (i + k <= n) {
+            size_t end = n - i < (size_t)k << 15 ? i + (n - i) / k * k : i + ((size_t)k << 15);
+            __m256i narrow = zero;
+            for (; i < end; i += k) {
+                __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + i)), b);
+                narrow = _mm256_add_epi32(narrow, _mm256_add_epi32(_mm256_unpacklo_epi16(v, zero), _mm256_unpackhi_epi16(v, zero)));
+            }
+            acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_unpacklo_epi32(narrow, zero), _mm256_unpackhi_epi32(narrow, zero)));
+        }
+    } else {
+        for (; i + k <= n; i += k) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + i)), b);
+            if constexpr (sizeof(U) == 1) {
+                acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero));
+            } else if constexpr (sizeof(U) == 4) {
+                acc = _mm256_add_epi64(acc, _mm256_add_epi64(_mm256_unpacklo_epi32(v, zero), _mm256_unpackhi_epi32(v, zero)));
+            } else {
+                acc = _mm256_add_epi64(acc, v);
+            }
+        }
+    }
+    return sum_lanes_avx2(acc) + sum_scalar(p + i, n - i, bias);
+}
+
+HELLO_AVX2 static double sum_f32_avx2(const float* p, size_t n) {
+    __m256d a = _mm256_setzero_pd();
+    __m256d b = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a = _mm256_add_pd(a, _mm256_cvtps_pd(_mm_loadu_ps(p + i)));
+        b = _mm256_add_pd(b, _mm256_cvtps_pd(_mm_loadu_ps(p + i + 4)));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(a, b));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_float_scalar(p + i, n - i);
+}
+
+HELLO_AVX2 static double sum_f64_avx2(const double* p, size_t n) {
+    __m256d a = _mm256_setzero_pd();
+    __m256d b = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a = _mm256_add_pd(a, _mm256_loadu_pd(p + i));
+        b = _mm256_add_pd(b, _mm256_loadu_pd(p + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(a, b));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_float_scalar(p + i, n - i);
+}
+
+template <size_t S> HELLO_AVX2 static inline __m128i add_sse(__m128i a, __m128i b) {
+    if constexpr (S == 1) {
+        return _mm_add_epi8(a, b);
+    } else if constexpr (S == 2) {
+        return _mm_add_epi16(a, b);
+    } else if constexpr (S == 4) {
+        return _mm_add_epi32(a, b);
+    } else {
+        return _mm_add_epi64(a, b);
+    }
+}
+
+template <typename U> HELLO_AVX2 static void prefix_avx2(U* p, size_t n) {
+    const size_t S = sizeof(U);
+    const size_t k = 16 / S;
+    /* The last element of a vector, in every element. */
+    const __m128i last = S == 1 ? _mm_set1_epi8(15) : S == 2 ? _mm_set1_epi16(0x0f0e) : S == 4 ? _mm_set1_epi32(0x0f0e0d0c)
+                                                                                            : _mm_set1_epi64x(0x0f0e0d0c0b0a0908ll);
+    __m128i carry = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + k <= n; i += k) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(p + i));
+        if constexpr (S == 1) {
+            x = add_sse<S>(x, _mm_slli_si128(x, 1));
+        }
+        if constexpr (S <= 2) {
+            x = add_sse<S>(x, _mm_slli_si128(x, 2));
+        }
+        if constexpr (S <= 4) {
+            x = add_sse<S>(x, _mm_slli_si128(x, 4));
+        }
+        x = add_sse<S>(x, _mm_slli_si128(x, 8));
+        x = add_sse<S>(x, carry);
+        _mm_storeu_si128((__m128i*)(p + i), x);
+        carry = _mm_shuffle_epi8(x, last);
+    }
+    prefix_scalar(p + i, n - i, i ? p[i - 1] : (U)0);
+}
+
+HELLO_AVX2 static void prefix_f32_avx2(float* p, size_t n) {
+    __m128 carry = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(p + i);
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4)));
+        x = _mm_add_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 8)));
+        x = _mm_add_ps(x, carry);
+        _mm_storeu_ps(p + i, x);
+        carry = _mm_shuffle_ps(x, x, 0xFF);
+    }
+    prefix_scalar(p + i, n - i, i ? p[i - 1] : 0.0f);
+}
+
+HELLO_AVX2 static void prefix_f64_avx2(double* p, size_t n) {
+    __m128d carry = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_loadu_pd(p + i);
+        x = _mm_add_pd(x, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(x), 8)));
+        x = _mm_add_pd(x, carry);
+        _mm_storeu_pd(p + i, x);
+        carry = _mm_unpackhi_pd(x, x);
+    }
+    prefix_scalar(p + i, n - i, i ? p[i - 1] : 0.0);
+}
+#endif
+
+/*** WASM SIMD128 *****************************************************/
+/*
+ * The same shapes at 16 bytes. Element reversal and byte swaps are single
+ * constant shuffles, the 64-bit min/max compares with the sign flipped,
+ * and narrow integer sums widen with pairwise extending adds into 32-bit
+ * lanes that are flushed to 64 bits before they can overflow. f32x4.min
+ * and max propagate NaN themselves.
+ */
+#ifdef __wasm_simd128__
+template <size_t S> static inline v128_t reverse_lanes_simd128(v128_t v) {
+    if constexpr (S == 1) {
+        return wasm_i8x16_shuffle(v, v, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    } else if constexpr (S == 2) {
+        return wasm_i8x16_shuffle(v, v, 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+    } else if constexpr (S == 4) {
+        return wasm_i8x16_shuffle(v, v, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    } else {
+        return wasm_i8x16_shuffle(v, v, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    }
+}
+
+template <typename T> static void reverse_simd128(T* p, size_t n) {
+    const size_t k = 16 / sizeof(T);
+    size_t i = 0;
+    size_t j = n;
+    for (; j - i >= 2 * k; i += k, j -= k) {
+        v128_t a = wasm_v128_load(p + i);
+        v128_t b = wasm_v128_load(p + j - k);
+        wasm_v128_store(p + i, reverse_lanes_simd128<sizeof(T)>(b));
+        wasm_v128_store(p + j - k, reverse_lanes_simd128<sizeof(T)>(a));
+    }
+    reverse_scalar(p + i, j - i);
+}
+
+template <size_t S> static inline v128_t byteswap_lanes_simd128(v128_t v) {
+    if constexpr (S == 2) {
+        return wasm_i8x16_shuffle(v, v, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    } else if constexpr (S == 4) {
+        return wasm_i8x16_shuffle(v, v, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    } else {
+        return wasm_i8x16_shuffle(v, v, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    }
+}
+
+template <typename T> static void byteswap_simd128(T* p, size_t n) {
+    if constexpr (sizeof(T) > 1) {
+        const size_t k = 16 / sizeof(T);
+        size_t i = 0;
+        for (; i + k <= n; i += k) {
+            wasm_v128_store(p + i, byteswap_lanes_simd128<sizeof(T)>(wasm_v128_load(p + i)));
+        }
+        byteswap_scalar(p + i, n - i);
+    }
+}
+
+template <typename U> static inline v128_t splat_simd128(U x) {
+    if constexpr (sizeof(U) == 1) {
+        return wasm_i8x16_splat((int8_t)x);
+    } else if constexpr (sizeof(U) == 2) {
+        return wasm_i16x8_splat((int16_t)x);
+    } else if constexpr (sizeof(U) == 4) {
+        return wasm_i32x4_splat((int32_t)x);
+    } else {
+        return wasm_i64x2_splat((int64_t)x);
+    }
+}
+
+template <typename U> static inline void minmax_lanes_simd128(v128_t* lo, v128_t* hi, v128_t v) {
+    if constexpr (sizeof(U) == 1) {
+        *lo = wasm_u8x16_min(*lo, v);
+        *hi = wasm_u8x16_max(*hi, v);
+    } else if constexpr (sizeof(U) == 2) {
+        *lo = wasm_u16x8_min(*lo, v);
+        *hi = wasm_u16x8_max(*hi, v);
+    } else if constexpr (sizeof(U) == 4) {
+        *lo = wasm_u32x4_min(*lo, v);
+        *hi = wasm_u32x4_max(*hi, v);
+    } else {
+        const v128_t sign = wasm_i64x2_splat(INT64_MIN);
+        v128_t s = wasm_v128_xor(v, sign);
+        *lo = wasm_v128_bitselect(v, *lo, wasm_i64x2_gt(wasm_v128_xor(*lo, sign), s));
+        *hi = wasm_v128_bitselect(v, *hi, wasm_i64x2_gt(s, wasm_v128_xor(*hi, sign)));
+    }
+}
+
+template <typename U> static void minmax_simd128(const U* p, size_t n, U bias, U* lo, U* hi) {
+    const size_t k = 16 / sizeof(U);
+    size_t i = 0;
+    if (n >= k) {
+        const v128_t b = splat_simd128<U>(bias);
+        v128_t vlo = wasm_v128_xor(wasm_v128_load(p), b);
+        v128_t vhi = vlo;
+        for (i = k; i + k <= n; i += k) {
+            minmax_lanes_simd128<U>(&vlo, &vhi, wasm_v128_xor(wasm_v128_load(p + i), b));
+        }
+        U lanes[2][16 / sizeof(U)];
+        wasm_v128_store(lanes[0], vlo);
+        wasm_v128_store(lanes[1], vhi);
+        minmax_scalar(lanes[0], k, (U)0, lo, hi);
+        minmax_scalar(lanes[1], k, (U)0, lo, hi);
+    }
+    minmax_scalar(p + i, n - i, bias, lo, hi);
+}
+
+template <typename T> static void minmax_float_simd128(const T* p, size_t n, T* lo, T* hi, bool* nan) {
+    const size_t k = 16 / sizeof(T);
+    size_t i = 0;
+    if (n >= k) {
+        v128_t vlo = wasm_v128_load(p);
+        v128_t vhi = vlo;
+        for (i = k; i + k <= n; i += k) {
+            v128_t v = wasm_v128_load(p + i);
+            if constexpr (sizeof(T) == 4) {
+                vlo = wasm_f32x4_min(vlo, v);
+                vhi = wasm_f32x4_max(vhi, v);
+            } else {
+                vlo = wasm_f64x2_min(vlo, v);
+                vhi = wasm_f64x2_max(vhi, v);
+            }
+        }
+        T lanes[2][16 / sizeof(T)];
+        wasm_v128_store(lanes[0], vlo);
+        wasm_v128_store(lanes[1], vhi);
+        minmax_float_scalar(lanes[0], k, lo, hi, nan);
+        minmax_float_scalar(lanes[1], k, lo, hi, nan);
+    }
+    minmax_float_scalar(p + i, n - i, lo, hi, nan);
+}
+
+static inline uint64_t sum_lanes_simd128(v128_t v) {
+    return (uint64_t)wasm_i64x2_extract_lane(v, 0) + (uint64_t)wasm_i64x2_extract_lane(v, 1);
+}
+
+static inline v128_t widen_add_simd128(v128_t acc, v128_t narrow) {
+    return wasm_i64x2_add(acc, wasm_i64x2_add(wasm_u64x2_extend_low_u32x4(narrow), wasm_u64x2_extend_high_u32x4(narrow)));
+}
+
+template <typename U> static uint64_t sum_simd128(const U* p, size_t n, U bias) {
+    const size_t k = 16 / sizeof(U);
+    const v128_t b = splat_simd128<U>(bias);
+    v128_t acc = wasm_i64x2_splat(0);
+    size_t i = 0;
+    if constexpr (sizeof(U) <= 2) {
+        /* A step adds at most 4 * 255 (bytes) or 2 * 65535 (halves) to a
+         * 32-bit lane; flush well before that can overflow. */
+        const size_t steps = sizeof(U) == 1 ? (size_t)1 << 20 : (size_t)1 << 15;
+        while (i + k <= n) {
+            size_t end = n - i < k * steps ? i + (n - i) / k * k : i + k * steps;
+            v128_t narrow = wasm_i32x4_splat(0);
+            for (; i < end; i += k) {
+                v128_t v = wasm_v128_xor(wasm_v128_load(p + i), b);
+                if constexpr (sizeof(U) == 1) {
+                    v = wasm_u16x8_extadd_pairwise_u8x16(v);
+                }
+                narrow = wasm_i32x4_add(narrow, wasm_u32x4_extadd_pairwise_u16x8(v));
+            }
+            acc = widen_add_simd128(acc, narrow);
+        }
+    } else {
+        for (; i + k <= n; i += k) {
+            v128_t v = wasm_v128_xor(wasm_v128_load(p + i), b);
+            acc = sizeof(U) == 4 ? widen_add_simd128(acc, v) : wasm_i64x2_add(acc, v);
+        }
+    }
+    return sum_lanes_simd128(acc) + sum_scalar(p + i, n - i, bias);
+}
+
+template <typename T> static double sum_float_simd128(const T* p, size_t n) {
+    v128_t acc = wasm_f64x2_splat(0);
+    const size_t k = 16 / sizeof(T);
+    size_t i = 0;
+    for (; i + k <= n; i += k) {
+        v128_t v = wasm_v128_load(p + i);
+        if constexpr (sizeof(T) == 4) {
+            acc = wasm_f64x2_add(acc, wasm_f64x2_promote_low_f32x4(v));
+            acc = wasm_f64x2_add(acc, wasm_f64x2_promote_low_f32x4(wasm_i32x4_shuffle(v, v, 2, 3, 0, 1)));
+        } else {
+            acc = wasm_f64x2_add(acc, v);
+        }
+    }
+    return wasm_f64x2_extract_lane(acc, 0) + wasm_f64x2_extract_lane(acc, 1) + sum_float_scalar(p + i, n - i);
+}
+
+/* Moves every byte K places up, shifting in zeros. */
+#define HELLO_SHIFT_UP(i) ((i) >= K ? (i) - K : 16)
+template <int K> static inline v128_t shift_up_simd128(v128_t x) {
+    const v128_t zero = wasm_i64x2_splat(0);
+    return wasm_i8x16_shuffle(x, zero, HELLO_SHIFT_UP(0), HELLO_SHIFT_UP(1), HELLO_SHIFT_UP(2), HELLO_SHIFT_UP(3),
+                              HELLO_SHIFT_UP(4), HELLO_SHIFT_UP(5), HELLO_SHIFT_UP(6), HELLO_SHIFT_UP(7), HELLO_SHIFT_UP(8),
+                              HELLO_SHIFT_UP(9), HELLO_SHIFT_UP(10), HELLO_SHIFT_UP(11), HELLO_SHIFT_UP(12),
+                              HELLO_SHIFT_UP(13), HELLO_SHIFT_UP(14), HELLO_SHIFT_UP(15));
+}
+#undef HELLO_SHIFT_UP
+
+/* The last element of a vector, in every element. */
+template <size_t S> static inline v128_t broadcast_last_simd128(v128_t x) {
+    if constexpr (S == 1) {
+        return wasm_i8x16_shuffle(x, x, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15);
+    } else if constexpr (S == 2) {
+        return wasm_i8x16_shuffle(x, x, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15, 14, 15);
+    } else if constexpr (S == 4) {
+        return wasm_i8x16_shuffle(x, x, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15, 12, 13, 14, 15);
+    } else {
+        return wasm_i8x16_shuffle(x, x, 8, 9, 10, 11, 12, 13, 14, 15, 8, 9, 10, 11, 12, 13, 14, 15);
+    }
+}
+
+template <typename T> static inline v128_t add_simd128(v128_t a, v128_t b) {
+    if constexpr (std::is_same<T, float>::value) {
+        return wasm_f32x4_add(a, b);
+    } else if constexpr (std::is_same<T, double>::value) {
+        return wasm_f64x2_add(a, b);
+    } else if constexpr (sizeof(T) == 1) {
+        return wasm_i8x16_add(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return wasm_i16x8_add(a, b);
+    } else if constexpr (sizeof(T) == 4) {
+        return wasm_i32x4_add(a, b);
+    } else {
+        return wasm_i64x2_add(a, b);
+    }
+}
+
+template <typename T> static void prefix_simd128(T* p, size_t n) {
+    const size_t S = sizeof(T);
+    const size_t k = 16 / S;
+    v128_t carry = wasm_i64x2_splat(0);
+    size_t i = 0;
+    for (; i + k <= n; i += k) {
+        v128_t x = wasm_v128_load(p + i);
+        if constexpr (S == 1) {
+            x = add_simd128<T>(x, shift_up_simd128<1>(x));
+        }
+        if constexpr (S <= 2) {
+            x = add_simd128<T>(x, shift_up_simd128<2>(x));
+        }
+        if constexpr (S <= 4) {
+            x = add_simd128<T>(x, shift_up_simd128<4>(x));
+        }
+        x = add_simd128<T>(x, shift_up_simd128<8>(x));
+        x = add_simd128<T>(x, carry);
+        wasm_v128_store(p + i, x);
+        carry = broadcast_last_simd128<S>(x);
+    }
+    prefix_scalar(p + i, n - i, i ? p[i - 1] : (T)0);
+}
+#endif
+
+/*** DISPATCH *********************************************************/
+static std::atomic<int> typed_array_backend_current(-1);
+
+bool typed_array_backend_supported(TypedArrayBackend backend) {
+    switch (backend) {
+    case TYPED_ARRAY_BACKEND_SCALAR:
+        return true;
+#ifdef HELLO_ARRAY_X86
+    case TYPED_ARRAY_BACKEND_AVX2:
+        return cpu_features().avx2;
+#endif
+#ifdef __wasm_simd128__
+    case TYPED_ARRAY_BACKEND_SIMD128:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+bool typed_array_set_backend(TypedArrayBackend backend) {
+    if (!typed_array_backend_supported(backend)) {
+        return false;
+    }
+    typed_array_backend_current.store(backend, std::memory_order_relaxed);
+    return true;
+}
+
+TypedArrayBackend typed_array_backend() {
+    int backend = typed_array_backend_current.load(std::memory_order_relaxed);
+    if (backend >= 0) {
+        return (TypedArrayBackend)backend;
+    }
+    const TypedArrayBackend preferred[] = {TYPED_ARRAY_BACKEND_AVX2, TYPED_ARRAY_BACKEND_SIMD128};
+    backend = TYPED_ARRAY_BACKEND_SCALAR;
+    for (auto candidate : preferred) {
+        if (typed_array_backend_supported(candidate)) {
+            backend = candidate;
+            break;
+        }
+    }
+    int unset = -1;
+    typed_array_backend_current.compare_exchange_strong(unset, backend, std::memory_order_relaxed);
+    return (TypedArrayBackend)typed_array_backend_current.load(std::memory_order_relaxed);
+}
+
+/* Each public template picks its kernel per call; the backend is a relaxed
+ * atomic load. Integer kernels run on the same-size unsigned type. */
+template <typename T> void array_Reverse(T* p, size_t n) {
+    switch (typed_array_backend()) {
+#ifdef HELLO_ARRAY_X86
+    case TYPED_ARRAY_BACKEND_AVX2:
+        return reverse_avx2(p, n);
+#endif
+#ifdef __wasm_simd128__
+    case TYPED_ARRAY_BACKEND_SIMD128:
+        return reverse_simd128(p, n);
+#endif
+    default:
+        return reverse_scalar(p, n);
+    }
+}
+
+template <typename T> void array_ByteSwap(T* p, size_t n) {
+    switch (typed_array_backend()) {
+#ifdef HELLO_ARRAY_X86
+    case TYPED_ARRAY_BACKEND_AVX2:
+        return byteswap_avx2(p, n);
+#endif
+#ifdef __wasm_simd128__
+    case TYPED_ARRAY_BACKEND_SIMD128:
+        return byteswap_simd128(p, n);
+#endif
+    default:
+        return byteswap_scalar(p, n);
+    }
+}
+
+template <typename T> bool array_MinMax(const T* p, size_t n, T* min, T* max) {
+    if (n == 0) {
+        return false;
+    }
+    if constexpr (std::is_floating_point<T>::value) {
+        T lo = p[0];
+        T hi = p[0];
+        bool nan = false;
+        switch (typed_array_backend()) {
+#ifdef HELLO_ARRAY_X86
+        case TYPED_ARRAY_BACKEND_AVX2:
+            if constexpr (sizeof(T) == 4) {
+                minmax_f32_avx2(p, n, &lo, &hi, &nan);
+            } else {
+                minmax_f64_avx2(p, n, &lo, &hi, &nan);
+            }
+            break;
+#endif
+#ifdef __wasm_simd128__
+        case TYPED_ARRAY_BACKEND_SIMD128:
+            minmax_float_simd128(p, n, &lo, &hi, &nan);
+            break;
+#endif
+        default:
+            minmax_float_scalar(p, n, &lo, &hi, &nan);
+        }
+        *min = nan ? std::numeric_limits<T>::quiet_NaN() : lo;
+        *max = nan ? std::numeric_limits<T>::quiet_NaN() : hi;
+    } else {
+        typedef BitsOf<T> U;
+        const U bias = sign_bias<T>();
+        const U* bits = (const U*)p;
+        U lo = (U)(bits[0] ^ bias);
+        U hi = lo;
+        switch (typed_array_backend()) {
+#ifdef HELLO_ARRAY_X86
+        case TYPED_ARRAY_BACKEND_AVX2:
+            minmax_avx2(bits, n, bias, &lo, &hi);
+            break;
+#endif
+#ifdef __wasm_simd128__
+        case TYPED_ARRAY_BACKEND_SIMD128:
+            minmax_simd128(bits, n, bias, &lo, &hi);
+            break;
+#endif
+        default:
+            minmax_scalar(bits, n, bias, &lo, &hi);
+        }
+        *min = (T)(U)(lo ^ bias);
+        *max = (T)(U)(hi ^ bias);
+    }
+    return true;
+}
+
+template <typename T> typename ArraySum<T>::type array_Sum(const T* p, size_t n) {
+    if constexpr (std::is_floating_point<T>::value) {
+        switch (typed_array_backend()) {
+#ifdef HELLO_ARRAY_X86
+        case TYPED_ARRAY_BACKEND_AVX2:
+            if constexpr (sizeof(T) == 4) {
+                return sum_f32_avx2(p, n);
+            } else {
+                return sum_f64_avx2(p, n);
+            }
+#endif
+#ifdef __wasm_simd128__
+        case TYPED_ARRAY_BACKEND_SIMD128:
+            return sum_float_simd128(p, n);
+#endif
+        default:
+            return sum_float_scalar(p, n);
+        }
+    } else {
+        typedef BitsOf<T> U;
+        const U bias = sign_bias<T>();
+        const U* bits = (const U*)p;
+        uint64_t sum;
+        switch (typed_array_backend()) {
+#ifdef HELLO_ARRAY_X86
+        case TYPED_ARRAY_BACKEND_AVX2:
+            sum = sum_avx2(bits, n, bias);
+            break;
+#endif
+#ifdef __wasm_simd128__
+        case TYPED_ARRAY_BACKEND_SIMD128:
+            sum = sum_simd128(bits, n, bias);
+            break;
+#endif
+        default:
+            sum = sum_scalar(bits, n, bias);
+        }
+        /* Every biased value was bias too large (mod 2^64). */
+        return (typename ArraySum<T>::type)(sum - (uint64_t)n * bias);
+    }
+}
+
+template <typename T> void array_PrefixSum(T* p, size_t n) {
+    typedef typename std::conditional<std::is_floating_point<T>::value, T, BitsOf<T>>::type V;
+    V* values = (V*)p;
+    switch (typed_array_backend()) {
+#ifdef HELLO_ARRAY_X86
+    case TYPED_ARRAY_BACKEND_AVX2:
+        if constexpr (std::is_same<V, float>::value) {
+            return prefix_f32_avx2(values, n);
+        } else if constexpr (std::is_same<V, double>::value) {
+            return prefix_f64_avx2(values, n);
+        } else {
+            return prefix_avx2(values, n);
+        }
+#endif
+#ifdef __wasm_simd128__
+    case TYPED_ARRAY_BACKEND_SIMD128:
+        return prefix_simd128(values, n);
+#endif
+    default:
+        return prefix_scalar(values, n, (V)0);
+    }
+}
+
+#define HELLO_TYPED_ARRAY_INSTANTIATE(T)                                      \
+    template void array_Reverse<T>(T*, size_t);                              \
+    template void array_ByteSwap<T>(T*, size_t);                             \
+    template bool array_MinMax<T>(const T*, size_t, T*, T*);                 \
+    template typename ArraySum<T>::type array_Sum<T>(const T*, size_t);      \
+    template void array_PrefixSum<T>(T*, size_t);
+HELLO_TYPED_ARRAY_INSTANTIATE(uint8_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(uint16_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(uint32_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(uint64_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(int8_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(int16_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(int32_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(int64_t)
+HELLO_TYPED_ARRAY_INSTANTIATE(float)
+HELLO_TYPED_ARRAY_INSTANTIATE(double)
+#undef HELLO_TYPED_ARRAY_INSTANTIATE
+
+} // namespace Hello
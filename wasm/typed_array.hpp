@@ -0,0 +1,100 @@
+#ifndef HELLO_TYPED_ARRAY_HPP
+#define HELLO_TYPED_ARRAY_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Hello
+{
+
+/*** TYPED ARRAY KERNELS **********************************************/
+/*
+ * In-place kernels over the element types of JS typed arrays, each one
+ * template instantiated per type: uint8_t .. uint64_t, int8_t .. int64_t,
+ * float and double.
+ *
+ *   array_Reverse     reverses the elements
+ *   array_ByteSwap    reverses the bytes of every element (endianness)
+ *   array_MinMax      smallest and largest element in one pass
+ *   array_Sum         sum, exact mod 2^64 for integers (in uint64_t or
+ *                     int64_t), in double for floats
+ *   array_PrefixSum   inclusive running sum in the element type, wrapping
+ *                     for integers
+ *
+ * Reverse and byte swap only depend on the element size. Integer prefix
+ * sums wrap the same either way, so signed types run on the unsigned
+ * kernels; min/max and sums of signed types do too, with the sign bit
+ * flipped on load.
+ *
+ * Float min/max is NaN if any element is NaN, like Math.min/Math.max.
+ * Float sums and prefix sums add in vector lanes, not strictly left to
+ * right, so the last bits can differ from a scalar loop (and between
+ * backends).
+ */
+enum TypedArrayType {
+    TYPED_ARRAY_U8 = 0,
+    TYPED_ARRAY_U16 = 1,
+    TYPED_ARRAY_U32 = 2,
+    TYPED_ARRAY_U64 = 3,
+    TYPED_ARRAY_I8 = 4,
+    TYPED_ARRAY_I16 = 5,
+    TYPED_ARRAY_I32 = 6,
+    TYPED_ARRAY_I64 = 7,
+    TYPED_ARRAY_F32 = 8,
+    TYPED_ARRAY_F64 = 9,
+    TYPED_ARRAY_TYPE_COUNT
+};
+
+// Result type of array_Sum<T>.
+template <typename T>
+struct ArraySum {
+    typedef uint64_t type;
+};
+template <> struct ArraySum<int8_t> { typedef int64_t type; };
+template <> struct ArraySum<int16_t> { typedef int64_t type; };
+template <> struct ArraySum<int32_t> { typedef int64_t type; };
+template <> struct ArraySum<int64_t> { typedef int64_t type; };
+template <> struct ArraySum<float> { typedef double type; };
+template <> struct ArraySum<double> { typedef double type; };
+
+template <typename T> void array_Reverse(T* p, size_t n);
+template <typename T> void array_ByteSwap(T* p, size_t n);
+// Returns false, leaving min and max alone, when n is 0.
+template <typename T> bool array_MinMax(const T* p, size_t n, T* min, T* max);
+template <typename T> typename ArraySum<T>::type array_Sum(const T* p, size_t n);
+template <typename T> void array_PrefixSum(T* p, size_t n);
+
+#define HELLO_TYPED_ARRAY_EXTERN(T)                                                  \
+    extern template void array_Reverse<T>(T*, size_t);                              \
+    extern template void array_ByteSwap<T>(T*, size_t);                             \
+    extern template bool array_MinMax<T>(const T*, size_t, T*, T*);                 \
+    extern template typename ArraySum<T>::type array_Sum<T>(const T*, size_t);      \
+    extern template void array_PrefixSum<T>(T*, size_t);
+HELLO_TYPED_ARRAY_EXTERN(uint8_t)
+HELLO_TYPED_ARRAY_EXTERN(uint16_t)
+HELLO_TYPED_ARRAY_EXTERN(uint32_t)
+HELLO_TYPED_ARRAY_EXTERN(uint64_t)
+HELLO_TYPED_ARRAY_EXTERN(int8_t)
+HELLO_TYPED_ARRAY_EXTERN(int16_t)
+HELLO_TYPED_ARRAY_EXTERN(int32_t)
+HELLO_TYPED_ARRAY_EXTERN(int64_t)
+HELLO_TYPED_ARRAY_EXTERN(float)
+HELLO_TYPED_ARRAY_EXTERN(double)
+#undef HELLO_TYPED_ARRAY_EXTERN
+
+// Vector kernels behind the templates, picked on first use like the hex
+// backends; typed_array_set_backend(TYPED_ARRAY_BACKEND_SCALAR) forces the
+// plain loops, e.g. to check the kernels against them.
+enum TypedArrayBackend {
+    TYPED_ARRAY_BACKEND_SCALAR = 0,
+    TYPED_ARRAY_BACKEND_AVX2 = 1,
+    TYPED_ARRAY_BACKEND_SIMD128 = 2,
+};
+
+TypedArrayBackend typed_array_backend();
+bool typed_array_backend_supported(TypedArrayBackend backend);
+bool typed_array_set_backend(TypedArrayBackend backend);
+
+} // namespace Hello
+
+#endif